@@ -48,6 +48,8 @@ if family == 'windows' then
 else
 	platform = "linux_x86_64"
 	settings.cc.flags:Add( "-Wconversion", "-Wextra", "-Wall", "-Werror", "-Wstrict-aliasing=2", "-" .. config )
+	settings.cc.flags:Add( "-pthread" )
+	settings.link.flags:Add( "-pthread" )
 end
 
 local output_path = PathJoin( BUILD_PATH, PathJoin( platform, PathJoin( compiler, config ) ) )
@@ -59,6 +61,26 @@ settings.link.Output = output_func
 local tests  = Link( settings, 'memcpy_util_test',  Compile( settings, 'test/memcpy_util_test.cpp' ) )
 local bench  = Link( settings, 'memcpy_util_bench', Compile( settings, 'bench/memcpy_util_bench.cpp' ) )
 
+-- memcpy_util_tune links one build of memcpy_util.h per candidate value of each tunable, see tune/memcpy_util_tune.cpp
+local tune_variants = {
+	{ "MEMCPY_UTIL_MEMSWAP_CHUNK_SIZE",       { 64, 128, 256, 512, 1024, 4096 } },
+	{ "MEMCPY_UTIL_MEMSWAP_UNROLL",           { 1, 2, 4, 8 } },
+	{ "MEMCPY_UTIL_ROTATE_TILE_SIZE",         { 16, 32, 64, 128 } },
+	{ "MEMCPY_UTIL_STREAM_PREFETCH_DISTANCE", { 64, 128, 256, 512, 1024, 2048 } },
+}
+
+local tune_objs = { Compile( settings, 'tune/memcpy_util_tune.cpp' ) }
+for _, tunable in ipairs( tune_variants ) do
+	for _, value in ipairs( tunable[2] ) do
+		local name    = string.lower( tunable[1] ) .. "_" .. value
+		local variant = settings:Copy()
+		variant.cc.defines:Add( tunable[1] .. "=" .. value, "MEMCPY_UTIL_TUNE_VARIANT=" .. name )
+		variant.cc.Output = function(settings, path) return PathJoin(output_path, name .. settings.config_ext) end
+		table.insert( tune_objs, Compile( variant, 'tune/memcpy_util_tune_variant.cpp' ) )
+	end
+end
+local tune   = Link( settings, 'memcpy_util_tune', tune_objs )
+
 test_args = " -v"
 if ScriptArgs["test"]  then test_args = test_args .. " -t " .. ScriptArgs["test"] end
 if ScriptArgs["suite"] then test_args = test_args .. " -s " .. ScriptArgs["suite"] end
@@ -67,11 +89,13 @@ if ScriptArgs["bench"] then test_args = test_args .. " -t " .. ScriptArgs["bench
 if family == "windows" then
         AddJob( "test",  "unittest",  string.gsub( tests, "/", "\\" ) .. test_args, tests, tests )
         AddJob( "bench", "bench",     string.gsub( bench, "/", "\\" ) .. test_args, bench, bench )
+        AddJob( "tune",  "tune",      string.gsub( tune,  "/", "\\" ) .. " memcpy_util_tuning.h", tune, tune )
 else
         AddJob( "test",     "unittest",  tests .. test_args, tests, tests )
         AddJob( "valgrind", "valgrind",  "valgrind -v --leak-check=full --track-origins=yes " .. tests .. test_args, tests, tests )
         AddJob( "bench",    "bench",  bench .. test_args, bench, bench )
+        AddJob( "tune",     "tune",   tune .. " memcpy_util_tuning.h", tune, tune )
 end
 
-PseudoTarget( "all", tests, bench )
+PseudoTarget( "all", tests, bench, tune )
 DefaultTarget( "all" )
@@ -45,14 +45,22 @@ static void fill_with_random_data(T(&arr)[ARR_SIZE])
     fill_with_random_data((uint8_t*)arr, ARR_SIZE * sizeof(T));
 }
 
+// buffers allocated during benchmark setup are the ones flushed before each sample with --cache=cold.
 template<typename T>
 T* alloc_random_buffer(size_t item_cnt)
 {
     T* buff = (T*)malloc(item_cnt * sizeof(T));
     fill_with_random_data((uint8_t*)buff, item_cnt * sizeof(T));
+    ubench_cache_range(buff, item_cnt * sizeof(T));
     return buff;
 }
 
+// pixel formats with odd item-sizes, 3, 6, 12 and 24 bytes.
+struct rgb8   { uint8_t  c[3]; };
+struct rgb16  { uint16_t c[3]; };
+struct rgb32f { float    c[3]; };
+struct rgb64f { double   c[3]; };
+
 ///////////////////////////////////////////////////////////////
 //                          memswap                          //
 ///////////////////////////////////////////////////////////////
@@ -65,12 +73,16 @@ UBENCH_NOINLINE void memswap_sse2_noinline       (void* ptr1, void* ptr2, size_t
 UBENCH_NOINLINE void memswap_sse2_unroll_noinline(void* ptr1, void* ptr2, size_t s) { memswap_sse2_unroll(ptr1, ptr2, s); }
 UBENCH_NOINLINE void memswap_avx_noinline        (void* ptr1, void* ptr2, size_t s) { memswap_avx        (ptr1, ptr2, s); }
 UBENCH_NOINLINE void memswap_avx_unroll_noinline (void* ptr1, void* ptr2, size_t s) { memswap_avx_unroll (ptr1, ptr2, s); }
+UBENCH_NOINLINE void memswap_avx512_noinline        (void* ptr1, void* ptr2, size_t s) { memswap_avx512        (ptr1, ptr2, s); }
+UBENCH_NOINLINE void memswap_avx512_unroll_noinline (void* ptr1, void* ptr2, size_t s) { memswap_avx512_unroll (ptr1, ptr2, s); }
+UBENCH_NOINLINE void memswap_sse2_stream_noinline   (void* ptr1, void* ptr2, size_t s) { memswap_sse2_stream   (ptr1, ptr2, s); }
+UBENCH_NOINLINE void memswap_avx_stream_noinline    (void* ptr1, void* ptr2, size_t s) { memswap_avx_stream    (ptr1, ptr2, s); }
 
 #include <algorithm>
 UBENCH_NOINLINE void memswap_std_swap_ranges_noinline(void* ptr1, void* ptr2, size_t s) { std::swap_ranges((uint8_t*)ptr1, (uint8_t*)ptr1 + s, (uint8_t*)ptr2); }
 UBENCH_NOINLINE void memswap_memcpy_only_noinline    (void* ptr1, void* ptr2, size_t s) { memcpy(ptr1, ptr2, s); }
 
-UBENCH_NOINLINE void* clear_cache_alloc() { return alloc_random_buffer<uint8_t>(32*1024*1024); }
+UBENCH_NOINLINE void* clear_cache_alloc() { void* buff = malloc(32*1024*1024); fill_with_random_data((uint8_t*)buff, 32*1024*1024); return buff; }
 UBENCH_NOINLINE void  clear_cache()       { free(clear_cache_alloc()); }
 
 #define BENCH_MEMSWAP_SMALL(TYPE)                          \
@@ -80,6 +92,8 @@ UBENCH_NOINLINE void  clear_cache()       { free(clear_cache_alloc()); }
         uint8_t b2[16];                                    \
         fill_with_random_data(b1);                         \
         fill_with_random_data(b2);                         \
+        ubench_cache_range(b1, sizeof(b1));                \
+        ubench_cache_range(b2, sizeof(b2));                \
         clear_cache();                                     \
                                                            \
         UBENCH_DO_BENCHMARK()                              \
@@ -96,7 +110,12 @@ UBENCH_NOINLINE void  clear_cache()       { free(clear_cache_alloc()); }
         uint8_t sb2[512];                                   \
         uint8_t* b1 = BUFSIZE <= sizeof(sb1) ? sb1 : alloc_random_buffer<uint8_t>(BUF_SZ); \
         uint8_t* b2 = BUFSIZE <= sizeof(sb2) ? sb2 : alloc_random_buffer<uint8_t>(BUF_SZ); \
+        fill_with_random_data(sb1);                         \
+        fill_with_random_data(sb2);                         \
+        if(BUFSIZE <= sizeof(sb1)) ubench_cache_range(sb1, BUF_SZ);                   \
+        if(BUFSIZE <= sizeof(sb2)) ubench_cache_range(sb2, BUF_SZ);                   \
         clear_cache();                                      \
+        UBENCH_SET_BYTES(BUF_SZ * 2);                       \
         UBENCH_DO_BENCHMARK()                               \
         {                                                   \
             memswap_##TYPE##_noinline(b1, b2, BUF_SZ);      \
@@ -117,6 +136,8 @@ BENCH_MEMSWAP_SMALL(sse2)
 BENCH_MEMSWAP_SMALL(sse2_unroll)
 BENCH_MEMSWAP_SMALL(avx)
 BENCH_MEMSWAP_SMALL(avx_unroll)
+BENCH_MEMSWAP_SMALL(avx512)
+BENCH_MEMSWAP_SMALL(avx512_unroll)
 
 BENCH_MEMSWAP_SMALL(std_swap_ranges)
 BENCH_MEMSWAP_SMALL(memcpy_only)
@@ -129,6 +150,10 @@ BENCH_MEMSWAP_BIG(sse2)
 BENCH_MEMSWAP_BIG(sse2_unroll)
 BENCH_MEMSWAP_BIG(avx)
 BENCH_MEMSWAP_BIG(avx_unroll)
+BENCH_MEMSWAP_BIG(avx512)
+BENCH_MEMSWAP_BIG(avx512_unroll)
+BENCH_MEMSWAP_BIG(sse2_stream)
+BENCH_MEMSWAP_BIG(avx_stream)
 
 BENCH_MEMSWAP_BIG(std_swap_ranges)
 BENCH_MEMSWAP_BIG(memcpy_only)
@@ -137,6 +162,10 @@ UBENCH_EX(memswap_stack, test)
 {
     char buff1[16*1024];
     char buff2[16*1024];
+    fill_with_random_data(buff1);
+    fill_with_random_data(buff2);
+    ubench_cache_range(buff1, sizeof(buff1));
+    ubench_cache_range(buff2, sizeof(buff2));
 	UBENCH_DO_BENCHMARK()
     {
         memswap_sse2_noinline(buff1, buff2, sizeof(buff1));
@@ -145,10 +174,183 @@ UBENCH_EX(memswap_stack, test)
     }
 }
 
+///////////////////////////////////////////////////////////////
+//                      memswap_parallel                     //
+///////////////////////////////////////////////////////////////
+
+#include <thread>
+
+// spawns threads on each call, a real thread-pool would have less overhead but this is good enough to see
+// how the _parallel-functions scale on buffers this big.
+static void bench_parallel_for( void (*job)( void* job_data, size_t job_index ), void* job_data, size_t job_count, void* userdata )
+{
+    (void)userdata;
+    std::thread threads[16];
+    for(size_t i = 1; i < job_count; ++i)
+        threads[i] = std::thread(job, job_data, i);
+    job(job_data, 0);
+    for(size_t i = 1; i < job_count; ++i)
+        threads[i].join();
+}
+
+#define BENCH_MEMSWAP_PARALLEL(THREADS)                                                   \
+    UBENCH_EX(memswap_parallel, threads_##THREADS)                                        \
+    {                                                                                     \
+        const size_t BUF_SZ = 64 * 1024 * 1024;                                           \
+        uint8_t* b1 = alloc_random_buffer<uint8_t>(BUF_SZ);                               \
+        uint8_t* b2 = alloc_random_buffer<uint8_t>(BUF_SZ);                               \
+        memcpy_util_parallel par = { bench_parallel_for, 0, THREADS, MEMCPY_UTIL_PARALLEL_MIN_BYTES }; \
+        UBENCH_SET_BYTES(BUF_SZ * 2);                                                     \
+        UBENCH_DO_BENCHMARK()                                                             \
+        {                                                                                 \
+            memswap_parallel(b1, b2, BUF_SZ, &par);                                       \
+        }                                                                                 \
+        free(b1);                                                                         \
+        free(b2);                                                                         \
+    }
+
+BENCH_MEMSWAP_PARALLEL(1)
+BENCH_MEMSWAP_PARALLEL(2)
+BENCH_MEMSWAP_PARALLEL(4)
+BENCH_MEMSWAP_PARALLEL(8)
+BENCH_MEMSWAP_PARALLEL(16)
+
 ///////////////////////////////////////////////////////////////
 //                        memcpy_rect                        //
 ///////////////////////////////////////////////////////////////
 
+// copy LINE_CNT lines of LINE_LEN bytes, a full image if the strides equal LINE_LEN and a sub-rect of a bigger image
+// otherwise.
+#define BENCH_MEMCPY_RECT_SIZE(LINE_CNT, LINE_LEN, DST_STRIDE, SRC_STRIDE)       \
+    uint8_t* b1 = alloc_random_buffer<uint8_t>(LINE_CNT * SRC_STRIDE);            \
+    uint8_t* b2 = alloc_random_buffer<uint8_t>(LINE_CNT * DST_STRIDE);            \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * 2);                                    \
+                                                                                  \
+    UBENCH_DO_BENCHMARK()                                                         \
+    {                                                                             \
+        UBENCH_DO_NOTHING(                                                        \
+            memcpy_rect(b2, b1, LINE_CNT, LINE_LEN, DST_STRIDE, SRC_STRIDE)       \
+        );                                                                        \
+    }                                                                             \
+                                                                                  \
+    free(b1);                                                                     \
+    free(b2);
+
+UBENCH_EX(memcpy_rect, full_2048x2048)      { BENCH_MEMCPY_RECT_SIZE( 2048, 2048, 2048, 2048); }
+UBENCH_EX(memcpy_rect, subrect_1024x1024)   { BENCH_MEMCPY_RECT_SIZE( 1024, 1024, 2048, 2048); }
+UBENCH_EX(memcpy_rect, subrect_unaligned)   { BENCH_MEMCPY_RECT_SIZE( 1024, 1021, 2051, 2047); }
+UBENCH_EX(memcpy_rect, short_lines_16b)     { BENCH_MEMCPY_RECT_SIZE(65536,   16,   64,   64); }
+
+#define BENCH_MEMCPY_RECT_PARALLEL(THREADS)                                               \
+    UBENCH_EX(memcpy_rect_parallel, threads_##THREADS)                                    \
+    {                                                                                     \
+        const size_t LINE_CNT = 8192;                                                     \
+        const size_t LINE_LEN = 8192;                                                     \
+        uint8_t* b1 = alloc_random_buffer<uint8_t>(LINE_CNT * LINE_LEN);                  \
+        uint8_t* b2 = alloc_random_buffer<uint8_t>(LINE_CNT * LINE_LEN);                  \
+        memcpy_util_parallel par = { bench_parallel_for, 0, THREADS, MEMCPY_UTIL_PARALLEL_MIN_BYTES }; \
+        UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * 2);                                        \
+        UBENCH_DO_BENCHMARK()                                                             \
+        {                                                                                 \
+            UBENCH_DO_NOTHING(                                                            \
+                memcpy_rect_parallel(b2, b1, LINE_CNT, LINE_LEN, LINE_LEN, LINE_LEN, &par) \
+            );                                                                            \
+        }                                                                                 \
+        free(b1);                                                                         \
+        free(b2);                                                                         \
+    }
+
+BENCH_MEMCPY_RECT_PARALLEL(1)
+BENCH_MEMCPY_RECT_PARALLEL(2)
+BENCH_MEMCPY_RECT_PARALLEL(4)
+BENCH_MEMCPY_RECT_PARALLEL(8)
+BENCH_MEMCPY_RECT_PARALLEL(16)
+
+
+///////////////////////////////////////////////////////////////
+//                        memmove_rect                       //
+///////////////////////////////////////////////////////////////
+
+// move a 1024x1024 byte rect within a 2048x2048 image, dst is offset DST_LINE lines and DST_ITEM bytes from src and
+// the strides can differ to get rects that move towards each other.
+#define BENCH_MEMMOVE_RECT_SIZE(DST_LINE, DST_ITEM, DST_STRIDE, SRC_STRIDE)   \
+    const size_t LINE_CNT = 1024;                                               \
+    const size_t LINE_LEN = 1024;                                               \
+    uint8_t* b1 = alloc_random_buffer<uint8_t>(4096 * 4096);                    \
+    uint8_t* src = b1 + 1024 * 4096 + 1024;                                     \
+    uint8_t* dst = src + (DST_LINE) * (ptrdiff_t)DST_STRIDE + (DST_ITEM);       \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * 2);                                  \
+                                                                                \
+    UBENCH_DO_BENCHMARK()                                                       \
+    {                                                                           \
+        UBENCH_DO_NOTHING(                                                      \
+            memmove_rect(dst, src, LINE_CNT, LINE_LEN, DST_STRIDE, SRC_STRIDE)  \
+        );                                                                      \
+    }                                                                           \
+                                                                                \
+    free(b1);
+
+UBENCH_EX(memmove_rect, no_overlap)        { BENCH_MEMMOVE_RECT_SIZE(1100,    0, 2048, 2048); }
+UBENCH_EX(memmove_rect, inplace)           { BENCH_MEMMOVE_RECT_SIZE(   0,    0, 2048, 2048); }
+UBENCH_EX(memmove_rect, one_line_down)     { BENCH_MEMMOVE_RECT_SIZE(   1,    0, 2048, 2048); }
+UBENCH_EX(memmove_rect, one_line_up)       { BENCH_MEMMOVE_RECT_SIZE(  -1,    0, 2048, 2048); }
+UBENCH_EX(memmove_rect, one_byte_right)    { BENCH_MEMMOVE_RECT_SIZE(   0,    1, 2048, 2048); }
+UBENCH_EX(memmove_rect, one_byte_left)     { BENCH_MEMMOVE_RECT_SIZE(   0,   -1, 2048, 2048); }
+UBENCH_EX(memmove_rect, diagonal)          { BENCH_MEMMOVE_RECT_SIZE(  16,   16, 2048, 2048); }
+UBENCH_EX(memmove_rect, converging_stride) { BENCH_MEMMOVE_RECT_SIZE(   0,  512, 2040, 2048); }
+UBENCH_EX(memmove_rect, diverging_stride)  { BENCH_MEMMOVE_RECT_SIZE(   0,  512, 2056, 2048); }
+
+///////////////////////////////////////////////////////////////
+//                   memcpy_rectrotr/rotl                    //
+///////////////////////////////////////////////////////////////
+
+#define BENCH_MEMCPY_RECTROT_SIZE(FUNC, LINE_CNT, LINE_LEN)      \
+    uint8_t* b1 = alloc_random_buffer<uint8_t>(LINE_CNT * LINE_LEN); \
+    uint8_t* b2 = alloc_random_buffer<uint8_t>(LINE_CNT * LINE_LEN); \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * 2);                   \
+                                                                 \
+    UBENCH_DO_BENCHMARK()                                        \
+    {                                                            \
+        UBENCH_DO_NOTHING(                                       \
+            FUNC(b2, b1,                                         \
+                 LINE_CNT, LINE_LEN,                             \
+                 LINE_CNT, LINE_LEN)                             \
+        );                                                       \
+    }                                                            \
+                                                                 \
+    free(b1);                                                    \
+    free(b2);
+
+UBENCH_EX(memcpy_rectrotr, 1024x1024) { BENCH_MEMCPY_RECTROT_SIZE(memcpy_rectrotr, 1024, 1024); }
+UBENCH_EX(memcpy_rectrotr, 4096x4096) { BENCH_MEMCPY_RECTROT_SIZE(memcpy_rectrotr, 4096, 4096); }
+UBENCH_EX(memcpy_rectrotr, 1080x1920) { BENCH_MEMCPY_RECTROT_SIZE(memcpy_rectrotr, 1080, 1920); }
+UBENCH_EX(memcpy_rectrotr, 8192x8192) { BENCH_MEMCPY_RECTROT_SIZE(memcpy_rectrotr, 8192, 8192); }
+UBENCH_EX(memcpy_rectrotl, 1024x1024) { BENCH_MEMCPY_RECTROT_SIZE(memcpy_rectrotl, 1024, 1024); }
+UBENCH_EX(memcpy_rectrotl, 4096x4096) { BENCH_MEMCPY_RECTROT_SIZE(memcpy_rectrotl, 4096, 4096); }
+UBENCH_EX(memcpy_rectrotl, 1080x1920) { BENCH_MEMCPY_RECTROT_SIZE(memcpy_rectrotl, 1080, 1920); }
+
+///////////////////////////////////////////////////////////////
+//                  memmove_rectrotr/rotl                    //
+///////////////////////////////////////////////////////////////
+
+// rotate a square in place, compare with memcpy_rectrotr of the same size.
+#define BENCH_MEMMOVE_RECTROT_SIZE(FUNC, SIZE)                   \
+    uint8_t* b1 = alloc_random_buffer<uint8_t>(SIZE * SIZE);     \
+    UBENCH_SET_BYTES(SIZE * SIZE * 2);                           \
+                                                                 \
+    UBENCH_DO_BENCHMARK()                                        \
+    {                                                            \
+        UBENCH_DO_NOTHING(                                       \
+            FUNC(b1, b1, SIZE, SIZE, SIZE, SIZE)                 \
+        );                                                       \
+    }                                                            \
+                                                                 \
+    free(b1);
+
+UBENCH_EX(memmove_rectrotr, 1024x1024) { BENCH_MEMMOVE_RECTROT_SIZE(memmove_rectrotr, 1024); }
+UBENCH_EX(memmove_rectrotr, 4096x4096) { BENCH_MEMMOVE_RECTROT_SIZE(memmove_rectrotr, 4096); }
+UBENCH_EX(memmove_rectrotr, 8192x8192) { BENCH_MEMMOVE_RECTROT_SIZE(memmove_rectrotr, 8192); }
+UBENCH_EX(memmove_rectrotl, 8192x8192) { BENCH_MEMMOVE_RECTROT_SIZE(memmove_rectrotl, 8192); }
 
 ///////////////////////////////////////////////////////////////
 //                      memcpy_rectfliph                     //
@@ -157,6 +359,7 @@ UBENCH_EX(memswap_stack, test)
 #define BENCH_MEMCPY_RECTFLIPH_SIZE(TYPE, LINE_CNT, LINE_LEN)  \
 	TYPE* b1 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN); \
     TYPE* b2 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN); \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * sizeof(TYPE) * 2);  \
                                                                \
 	UBENCH_DO_BENCHMARK()                                      \
 	{                                                          \
@@ -175,7 +378,167 @@ UBENCH_EX(memcpy_rectfliph, uint8_t)  { BENCH_MEMCPY_RECTFLIPH_SIZE( uint8_t, 20
 UBENCH_EX(memcpy_rectfliph, uint16_t) { BENCH_MEMCPY_RECTFLIPH_SIZE(uint16_t, 1024, 2048); }
 UBENCH_EX(memcpy_rectfliph, uint32_t) { BENCH_MEMCPY_RECTFLIPH_SIZE(uint32_t, 1024, 1024); }
 UBENCH_EX(memcpy_rectfliph, uint64_t) { BENCH_MEMCPY_RECTFLIPH_SIZE(uint64_t,  512, 1024); }
-// TODO: benchmark "uneven size items!"
+UBENCH_EX(memcpy_rectfliph, rgb8)     { BENCH_MEMCPY_RECTFLIPH_SIZE(    rgb8, 1024, 2048); }
+UBENCH_EX(memcpy_rectfliph, rgb16)    { BENCH_MEMCPY_RECTFLIPH_SIZE(   rgb16, 1024, 1024); }
+UBENCH_EX(memcpy_rectfliph, rgb32f)   { BENCH_MEMCPY_RECTFLIPH_SIZE(  rgb32f,  512, 1024); }
+UBENCH_EX(memcpy_rectfliph, rgb64f)   { BENCH_MEMCPY_RECTFLIPH_SIZE(  rgb64f,  512,  512); }
+
+///////////////////////////////////////////////////////////////
+//                 memcpy_rectrotr_x/rotl_x                  //
+///////////////////////////////////////////////////////////////
+
+#define BENCH_MEMCPY_RECTROT_X_SIZE(FUNC, TYPE, LINE_CNT, LINE_LEN)  \
+	TYPE* b1 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);       \
+    TYPE* b2 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);       \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * sizeof(TYPE) * 2);        \
+                                                                     \
+	UBENCH_DO_BENCHMARK()                                            \
+	{                                                                \
+		UBENCH_DO_NOTHING(                                           \
+            FUNC(b2, b1,                                             \
+                 LINE_CNT, LINE_LEN,                                 \
+                 LINE_CNT, LINE_LEN,                                 \
+                 sizeof(b1[0]))                                      \
+        );                                                           \
+	}                                                                \
+                                                                     \
+    free(b1);                                                        \
+    free(b2);
+
+UBENCH_EX(memcpy_rectrotr_x, uint8_t)  { BENCH_MEMCPY_RECTROT_X_SIZE(memcpy_rectrotr_x,  uint8_t, 2048, 2048); }
+UBENCH_EX(memcpy_rectrotr_x, uint16_t) { BENCH_MEMCPY_RECTROT_X_SIZE(memcpy_rectrotr_x, uint16_t, 1024, 2048); }
+UBENCH_EX(memcpy_rectrotr_x, uint32_t) { BENCH_MEMCPY_RECTROT_X_SIZE(memcpy_rectrotr_x, uint32_t, 1024, 1024); }
+UBENCH_EX(memcpy_rectrotr_x, uint64_t) { BENCH_MEMCPY_RECTROT_X_SIZE(memcpy_rectrotr_x, uint64_t,  512, 1024); }
+UBENCH_EX(memcpy_rectrotl_x, uint8_t)  { BENCH_MEMCPY_RECTROT_X_SIZE(memcpy_rectrotl_x,  uint8_t, 2048, 2048); }
+UBENCH_EX(memcpy_rectrotl_x, uint16_t) { BENCH_MEMCPY_RECTROT_X_SIZE(memcpy_rectrotl_x, uint16_t, 1024, 2048); }
+UBENCH_EX(memcpy_rectrotl_x, uint32_t) { BENCH_MEMCPY_RECTROT_X_SIZE(memcpy_rectrotl_x, uint32_t, 1024, 1024); }
+UBENCH_EX(memcpy_rectrotl_x, uint64_t) { BENCH_MEMCPY_RECTROT_X_SIZE(memcpy_rectrotl_x, uint64_t,  512, 1024); }
+
+// ... 2048x2048 images in common pixel-formats ...
+#define BENCH_MEMCPY_RECTROT_X_IMAGE(FUNC, ITEM_SIZE)                               \
+    const size_t IMG_SIZE = 2048;                                                   \
+    uint8_t* b1 = alloc_random_buffer<uint8_t>(IMG_SIZE * IMG_SIZE * ITEM_SIZE);    \
+    uint8_t* b2 = alloc_random_buffer<uint8_t>(IMG_SIZE * IMG_SIZE * ITEM_SIZE);    \
+    UBENCH_SET_BYTES(IMG_SIZE * IMG_SIZE * ITEM_SIZE * 2);                          \
+                                                                                    \
+    UBENCH_DO_BENCHMARK()                                                           \
+    {                                                                               \
+        UBENCH_DO_NOTHING(                                                          \
+            FUNC(b2, b1, IMG_SIZE, IMG_SIZE, IMG_SIZE, IMG_SIZE, ITEM_SIZE)         \
+        );                                                                          \
+    }                                                                               \
+                                                                                    \
+    free(b1);                                                                       \
+    free(b2);
+
+UBENCH_EX(memcpy_rectrotr_x, rg8_2048)     { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotr_x,  2); }
+UBENCH_EX(memcpy_rectrotr_x, rgb8_2048)    { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotr_x,  3); }
+UBENCH_EX(memcpy_rectrotr_x, rgba8_2048)   { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotr_x,  4); }
+UBENCH_EX(memcpy_rectrotr_x, rgba16f_2048) { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotr_x,  8); }
+UBENCH_EX(memcpy_rectrotr_x, rgb32f_2048)  { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotr_x, 12); }
+UBENCH_EX(memcpy_rectrotr_x, rgba32f_2048) { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotr_x, 16); }
+UBENCH_EX(memcpy_rectrotl_x, rg8_2048)     { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotl_x,  2); }
+UBENCH_EX(memcpy_rectrotl_x, rgb8_2048)    { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotl_x,  3); }
+UBENCH_EX(memcpy_rectrotl_x, rgba8_2048)   { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotl_x,  4); }
+UBENCH_EX(memcpy_rectrotl_x, rgba16f_2048) { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotl_x,  8); }
+UBENCH_EX(memcpy_rectrotl_x, rgb32f_2048)  { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotl_x, 12); }
+UBENCH_EX(memcpy_rectrotl_x, rgba32f_2048) { BENCH_MEMCPY_RECTROT_X_IMAGE(memcpy_rectrotl_x, 16); }
+
+// rotate a 1024x1024 sub-rect of a 2048x2048 image into another 2048x2048 image.
+#define BENCH_MEMCPY_RECTROT_X_SUBRECT(FUNC, TYPE)                  \
+	TYPE* b1 = alloc_random_buffer<TYPE>(2048 * 2048);              \
+    TYPE* b2 = alloc_random_buffer<TYPE>(2048 * 2048);              \
+    UBENCH_SET_BYTES(1024 * 1024 * sizeof(TYPE) * 2);               \
+                                                                    \
+	UBENCH_DO_BENCHMARK()                                           \
+	{                                                               \
+		UBENCH_DO_NOTHING(                                          \
+            FUNC(b2 + 512 * 2048 + 512, b1 + 256 * 2048 + 256,      \
+                 1024, 1024,                                        \
+                 2048, 2048,                                        \
+                 sizeof(b1[0]))                                     \
+        );                                                          \
+	}                                                               \
+                                                                    \
+    free(b1);                                                       \
+    free(b2);
+
+UBENCH_EX(memcpy_rectrotr_x, subrect_uint8_t)  { BENCH_MEMCPY_RECTROT_X_SUBRECT(memcpy_rectrotr_x,  uint8_t); }
+UBENCH_EX(memcpy_rectrotr_x, subrect_uint32_t) { BENCH_MEMCPY_RECTROT_X_SUBRECT(memcpy_rectrotr_x, uint32_t); }
+UBENCH_EX(memcpy_rectrotl_x, subrect_uint8_t)  { BENCH_MEMCPY_RECTROT_X_SUBRECT(memcpy_rectrotl_x,  uint8_t); }
+UBENCH_EX(memcpy_rectrotl_x, subrect_uint32_t) { BENCH_MEMCPY_RECTROT_X_SUBRECT(memcpy_rectrotl_x, uint32_t); }
+
+///////////////////////////////////////////////////////////////
+//                 memmove_rectrotr_x/rotl_x                 //
+///////////////////////////////////////////////////////////////
+
+// rotate a square in place.
+#define BENCH_MEMMOVE_RECTROT_X_SIZE(FUNC, TYPE, SIZE, STRIDE)      \
+	TYPE* b1 = alloc_random_buffer<TYPE>(SIZE * STRIDE);            \
+    UBENCH_SET_BYTES(SIZE * SIZE * sizeof(TYPE) * 2);               \
+                                                                    \
+	UBENCH_DO_BENCHMARK()                                           \
+	{                                                               \
+		UBENCH_DO_NOTHING(                                          \
+            FUNC(b1, b1, SIZE, SIZE, STRIDE, STRIDE, sizeof(b1[0])) \
+        );                                                          \
+	}                                                               \
+                                                                    \
+    free(b1);
+
+// rotate a non-square rect with dst overlapping src, dst is offset DST_LINE lines and DST_ITEM items from src in an
+// image with STRIDE items per line. This is where dst and src overlap without being the same square.
+#define BENCH_MEMMOVE_RECTROT_X_OVERLAP(FUNC, TYPE, LINE_CNT, LINE_LEN, STRIDE, DST_LINE, DST_ITEM) \
+	TYPE* b1 = alloc_random_buffer<TYPE>(STRIDE * STRIDE);                                           \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * sizeof(TYPE) * 2);                                        \
+                                                                                                     \
+	UBENCH_DO_BENCHMARK()                                                                            \
+	{                                                                                                \
+		UBENCH_DO_NOTHING(                                                                           \
+            FUNC(b1 + DST_LINE * STRIDE + DST_ITEM, b1,                                              \
+                 LINE_CNT, LINE_LEN,                                                                 \
+                 STRIDE, STRIDE,                                                                     \
+                 sizeof(b1[0]))                                                                      \
+        );                                                                                           \
+	}                                                                                                \
+                                                                                                     \
+    free(b1);
+
+// rotate into another buffer, this should be as fast as memcpy_rectrot*_x.
+#define BENCH_MEMMOVE_RECTROT_X_NO_OVERLAP(FUNC, TYPE, LINE_CNT, LINE_LEN) \
+	TYPE* b1 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);             \
+    TYPE* b2 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);             \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * sizeof(TYPE) * 2);              \
+                                                                           \
+	UBENCH_DO_BENCHMARK()                                                  \
+	{                                                                      \
+		UBENCH_DO_NOTHING(                                                 \
+            FUNC(b2, b1,                                                   \
+                 LINE_CNT, LINE_LEN,                                       \
+                 LINE_CNT, LINE_LEN,                                       \
+                 sizeof(b1[0]))                                            \
+        );                                                                 \
+	}                                                                      \
+                                                                           \
+    free(b1);                                                              \
+    free(b2);
+
+UBENCH_EX(memmove_rectrotr_x, uint8_t)             { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotr_x,  uint8_t, 2048, 2048); }
+UBENCH_EX(memmove_rectrotr_x, uint16_t)            { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotr_x, uint16_t, 1024, 1024); }
+UBENCH_EX(memmove_rectrotr_x, uint32_t)            { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotr_x, uint32_t, 1024, 1024); }
+UBENCH_EX(memmove_rectrotr_x, uint64_t)            { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotr_x, uint64_t,  512,  512); }
+UBENCH_EX(memmove_rectrotr_x, rgb8)                { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotr_x,     rgb8, 1024, 1024); }
+UBENCH_EX(memmove_rectrotr_x, subrect_uint32_t)    { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotr_x, uint32_t, 1024, 2048); }
+UBENCH_EX(memmove_rectrotr_x, overlap_uint32_t)    { BENCH_MEMMOVE_RECTROT_X_OVERLAP(memmove_rectrotr_x, uint32_t, 128, 256, 512, 64, 32); }
+UBENCH_EX(memmove_rectrotr_x, no_overlap_uint32_t) { BENCH_MEMMOVE_RECTROT_X_NO_OVERLAP(memmove_rectrotr_x, uint32_t, 1024, 1024); }
+UBENCH_EX(memmove_rectrotl_x, uint8_t)             { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotl_x,  uint8_t, 2048, 2048); }
+UBENCH_EX(memmove_rectrotl_x, uint16_t)            { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotl_x, uint16_t, 1024, 1024); }
+UBENCH_EX(memmove_rectrotl_x, uint32_t)            { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotl_x, uint32_t, 1024, 1024); }
+UBENCH_EX(memmove_rectrotl_x, uint64_t)            { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotl_x, uint64_t,  512,  512); }
+UBENCH_EX(memmove_rectrotl_x, rgb8)                { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotl_x,     rgb8, 1024, 1024); }
+UBENCH_EX(memmove_rectrotl_x, subrect_uint32_t)    { BENCH_MEMMOVE_RECTROT_X_SIZE(memmove_rectrotl_x, uint32_t, 1024, 2048); }
+UBENCH_EX(memmove_rectrotl_x, overlap_uint32_t)    { BENCH_MEMMOVE_RECTROT_X_OVERLAP(memmove_rectrotl_x, uint32_t, 128, 256, 512, 64, 32); }
+UBENCH_EX(memmove_rectrotl_x, no_overlap_uint32_t) { BENCH_MEMMOVE_RECTROT_X_NO_OVERLAP(memmove_rectrotl_x, uint32_t, 1024, 1024); }
 
 
 ///////////////////////////////////////////////////////////////
@@ -200,7 +563,10 @@ UBENCH_EX(memmove_rectfliph, uint8_t)  { BENCH_MEMMOVE_RECTFLIPH_SIZE( uint8_t,
 UBENCH_EX(memmove_rectfliph, uint16_t) { BENCH_MEMMOVE_RECTFLIPH_SIZE(uint16_t, 1024, 2048); }
 UBENCH_EX(memmove_rectfliph, uint32_t) { BENCH_MEMMOVE_RECTFLIPH_SIZE(uint32_t, 1024, 1024); }
 UBENCH_EX(memmove_rectfliph, uint64_t) { BENCH_MEMMOVE_RECTFLIPH_SIZE(uint64_t,  512, 1024); }
-// TODO: benchmark "uneven size items!"
+UBENCH_EX(memmove_rectfliph, rgb8)     { BENCH_MEMMOVE_RECTFLIPH_SIZE(    rgb8, 1024, 2048); }
+UBENCH_EX(memmove_rectfliph, rgb16)    { BENCH_MEMMOVE_RECTFLIPH_SIZE(   rgb16, 1024, 1024); }
+UBENCH_EX(memmove_rectfliph, rgb32f)   { BENCH_MEMMOVE_RECTFLIPH_SIZE(  rgb32f,  512, 1024); }
+UBENCH_EX(memmove_rectfliph, rgb64f)   { BENCH_MEMMOVE_RECTFLIPH_SIZE(  rgb64f,  512,  512); }
 
 ///////////////////////////////////////////////////////////////
 //                      memcpy_rectfliph                     //
@@ -209,6 +575,7 @@ UBENCH_EX(memmove_rectfliph, uint64_t) { BENCH_MEMMOVE_RECTFLIPH_SIZE(uint64_t,
 #define BENCH_MEMCPY_RECTFLIPV_SIZE(TYPE, LINE_CNT, LINE_LEN)   \
 	TYPE* b1 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);  \
     TYPE* b2 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);  \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * sizeof(TYPE) * 2);   \
                                                                 \
 	UBENCH_DO_BENCHMARK()                                       \
 	{                                                           \
@@ -227,7 +594,10 @@ UBENCH_EX(memcpy_rectflipv, uint8_t)  { BENCH_MEMCPY_RECTFLIPV_SIZE( uint8_t, 20
 UBENCH_EX(memcpy_rectflipv, uint16_t) { BENCH_MEMCPY_RECTFLIPV_SIZE(uint16_t, 1024, 2048); }
 UBENCH_EX(memcpy_rectflipv, uint32_t) { BENCH_MEMCPY_RECTFLIPV_SIZE(uint32_t, 1024, 1024); }
 UBENCH_EX(memcpy_rectflipv, uint64_t) { BENCH_MEMCPY_RECTFLIPV_SIZE(uint64_t,  512, 1024); }
-// TODO: benchmark "uneven size items!"
+UBENCH_EX(memcpy_rectflipv, rgb8)     { BENCH_MEMCPY_RECTFLIPV_SIZE(    rgb8, 1024, 2048); }
+UBENCH_EX(memcpy_rectflipv, rgb16)    { BENCH_MEMCPY_RECTFLIPV_SIZE(   rgb16, 1024, 1024); }
+UBENCH_EX(memcpy_rectflipv, rgb32f)   { BENCH_MEMCPY_RECTFLIPV_SIZE(  rgb32f,  512, 1024); }
+UBENCH_EX(memcpy_rectflipv, rgb64f)   { BENCH_MEMCPY_RECTFLIPV_SIZE(  rgb64f,  512,  512); }
 
 ///////////////////////////////////////////////////////////////
 //                      memmove_rectfliph                    //
@@ -235,6 +605,7 @@ UBENCH_EX(memcpy_rectflipv, uint64_t) { BENCH_MEMCPY_RECTFLIPV_SIZE(uint64_t,  5
 
 #define BENCH_MEMMOVE_RECTFLIPV_SIZE(TYPE, LINE_CNT, LINE_LEN) \
 	TYPE* b1 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN); \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * sizeof(TYPE) * 2);  \
                                                                \
 	UBENCH_DO_BENCHMARK()                                      \
 	{                                                          \
@@ -251,12 +622,170 @@ UBENCH_EX(memmove_rectflipv, uint8_t)  { BENCH_MEMMOVE_RECTFLIPV_SIZE( uint8_t,
 UBENCH_EX(memmove_rectflipv, uint16_t) { BENCH_MEMMOVE_RECTFLIPV_SIZE(uint16_t, 1024, 2048); }
 UBENCH_EX(memmove_rectflipv, uint32_t) { BENCH_MEMMOVE_RECTFLIPV_SIZE(uint32_t, 1024, 1024); }
 UBENCH_EX(memmove_rectflipv, uint64_t) { BENCH_MEMMOVE_RECTFLIPV_SIZE(uint64_t,  512, 1024); }
+UBENCH_EX(memmove_rectflipv, rgb8)     { BENCH_MEMMOVE_RECTFLIPV_SIZE(    rgb8, 1024, 2048); }
+UBENCH_EX(memmove_rectflipv, rgb16)    { BENCH_MEMMOVE_RECTFLIPV_SIZE(   rgb16, 1024, 1024); }
+UBENCH_EX(memmove_rectflipv, rgb32f)   { BENCH_MEMMOVE_RECTFLIPV_SIZE(  rgb32f,  512, 1024); }
+UBENCH_EX(memmove_rectflipv, rgb64f)   { BENCH_MEMMOVE_RECTFLIPV_SIZE(  rgb64f,  512,  512); }
+
+///////////////////////////////////////////////////////////////
+//                     memcpy_rectrot180                     //
+///////////////////////////////////////////////////////////////
+
+#define BENCH_MEMCPY_RECTROT180_SIZE(TYPE, LINE_CNT, LINE_LEN)  \
+	TYPE* b1 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);  \
+    TYPE* b2 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);  \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * sizeof(TYPE) * 2);   \
+                                                                \
+	UBENCH_DO_BENCHMARK()                                       \
+	{                                                           \
+		UBENCH_DO_NOTHING(                                      \
+            memcpy_rectrot180(b2, b1,                           \
+                              LINE_CNT, LINE_LEN,               \
+                              LINE_LEN, LINE_LEN,               \
+                              sizeof(b1[0]))                    \
+        );                                                      \
+	}                                                           \
+                                                                \
+    free(b1);                                                   \
+    free(b2);
+
+// ... the same rotate done as a flip followed by an in place flip, as it had to be done before memcpy_rectrot180 ...
+#define BENCH_MEMCPY_RECTROT180_FLIP_SIZE(TYPE, LINE_CNT, LINE_LEN) \
+	TYPE* b1 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);      \
+    TYPE* b2 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);      \
+                                                                    \
+	UBENCH_DO_BENCHMARK()                                           \
+	{                                                               \
+		memcpy_rectfliph(b2, b1,                                    \
+                         LINE_CNT, LINE_LEN,                        \
+                         LINE_LEN, LINE_LEN,                        \
+                         sizeof(b1[0]));                            \
+		UBENCH_DO_NOTHING(                                          \
+            memmove_rectflipv(b2, b2,                               \
+                              LINE_CNT, LINE_LEN,                   \
+                              LINE_LEN, LINE_LEN,                   \
+                              sizeof(b1[0]))                        \
+        );                                                          \
+	}                                                               \
+                                                                    \
+    free(b1);                                                       \
+    free(b2);
+
+UBENCH_EX(memcpy_rectrot180, uint8_t)       { BENCH_MEMCPY_RECTROT180_SIZE( uint8_t, 2048, 2048); }
+UBENCH_EX(memcpy_rectrot180, uint16_t)      { BENCH_MEMCPY_RECTROT180_SIZE(uint16_t, 1024, 2048); }
+UBENCH_EX(memcpy_rectrot180, uint32_t)      { BENCH_MEMCPY_RECTROT180_SIZE(uint32_t, 1024, 1024); }
+UBENCH_EX(memcpy_rectrot180, uint64_t)      { BENCH_MEMCPY_RECTROT180_SIZE(uint64_t,  512, 1024); }
+UBENCH_EX(memcpy_rectrot180, uint32_t_flip) { BENCH_MEMCPY_RECTROT180_FLIP_SIZE(uint32_t, 1024, 1024); }
+
+///////////////////////////////////////////////////////////////
+//                     memmove_rectrot180                    //
+///////////////////////////////////////////////////////////////
+
+#define BENCH_MEMMOVE_RECTROT180_SIZE(TYPE, LINE_CNT, LINE_LEN) \
+	TYPE* b1 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);  \
+                                                                \
+	UBENCH_DO_BENCHMARK()                                       \
+	{                                                           \
+        UBENCH_DO_NOTHING(                                      \
+		    memmove_rectrot180(b1, b1,                          \
+                               LINE_CNT, LINE_LEN,              \
+                               LINE_LEN, LINE_LEN,              \
+                               sizeof(b1[0]))                   \
+        );                                                      \
+	}                                                           \
+    free(b1);
+
+UBENCH_EX(memmove_rectrot180, uint8_t)  { BENCH_MEMMOVE_RECTROT180_SIZE( uint8_t, 2048, 2048); }
+UBENCH_EX(memmove_rectrot180, uint16_t) { BENCH_MEMMOVE_RECTROT180_SIZE(uint16_t, 1024, 2048); }
+UBENCH_EX(memmove_rectrot180, uint32_t) { BENCH_MEMMOVE_RECTROT180_SIZE(uint32_t, 1024, 1024); }
+UBENCH_EX(memmove_rectrot180, uint64_t) { BENCH_MEMMOVE_RECTROT180_SIZE(uint64_t,  512, 1024); }
+
+///////////////////////////////////////////////////////////////
+//                  memmove_rectrotr_scratch                 //
+///////////////////////////////////////////////////////////////
+
+// rotate a non-square rect in place with SCRATCH_SIZE bytes of scratch, i.e. an image turned from landscape to portrait.
+#define BENCH_MEMMOVE_RECTROTR_SCRATCH_SIZE(TYPE, LINE_CNT, LINE_LEN, SCRATCH_SIZE) \
+	TYPE* b1 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);                      \
+	uint8_t* scratch = (uint8_t*)malloc(SCRATCH_SIZE);                              \
+    ubench_cache_range(scratch, SCRATCH_SIZE);                                      \
+                                                                                    \
+	UBENCH_DO_BENCHMARK()                                                           \
+	{                                                                               \
+        UBENCH_DO_NOTHING(                                                          \
+		    memmove_rectrotr_scratch(b1, b1,                                        \
+                                     LINE_CNT, LINE_LEN,                            \
+                                     LINE_CNT, LINE_LEN,                            \
+                                     sizeof(b1[0]),                                 \
+                                     scratch, SCRATCH_SIZE)                         \
+        );                                                                          \
+	}                                                                               \
+    free(scratch);                                                                  \
+    free(b1);
+
+UBENCH_EX(memmove_rectrotr_scratch, uint32_t_line)   { BENCH_MEMMOVE_RECTROTR_SCRATCH_SIZE(uint32_t, 1080, 1920, 1920 * sizeof(uint32_t)); }
+UBENCH_EX(memmove_rectrotr_scratch, uint32_t_band)   { BENCH_MEMMOVE_RECTROTR_SCRATCH_SIZE(uint32_t, 1080, 1920, 1080 * 64 * sizeof(uint32_t)); }
+UBENCH_EX(memmove_rectrotr_scratch, uint32_t_bitset) { BENCH_MEMMOVE_RECTROTR_SCRATCH_SIZE(uint32_t, 1080, 1920, (1080 * 1920 + 7) / 8); }
+UBENCH_EX(memmove_rectrotr_scratch, uint32_t_full)   { BENCH_MEMMOVE_RECTROTR_SCRATCH_SIZE(uint32_t, 1080, 1920, 1080 * 1920 * sizeof(uint32_t)); }
+
+///////////////////////////////////////////////////////////////
+//                     memcpy_rectorient                     //
+///////////////////////////////////////////////////////////////
+
+#define BENCH_MEMCPY_RECTORIENT_SIZE(ORIENT, TYPE, LINE_CNT, LINE_LEN) \
+	TYPE* b1 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);         \
+    TYPE* b2 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);         \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * sizeof(TYPE) * 2);          \
+                                                                       \
+	UBENCH_DO_BENCHMARK()                                              \
+	{                                                                  \
+		UBENCH_DO_NOTHING(                                             \
+            memcpy_rectorient(b2, b1,                                  \
+                              LINE_CNT, LINE_LEN,                      \
+                              LINE_CNT, LINE_LEN,                      \
+                              sizeof(b1[0]), ORIENT)                   \
+        );                                                             \
+	}                                                                  \
+                                                                       \
+    free(b1);                                                          \
+    free(b2);
+
+// ... the transpose done as a rotate followed by an in place flip ...
+#define BENCH_MEMCPY_RECTORIENT_CHAINED_SIZE(TYPE, LINE_CNT, LINE_LEN) \
+	TYPE* b1 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);         \
+    TYPE* b2 = alloc_random_buffer<TYPE>(LINE_CNT * LINE_LEN);         \
+    UBENCH_SET_BYTES(LINE_CNT * LINE_LEN * sizeof(TYPE) * 2);          \
+                                                                       \
+	UBENCH_DO_BENCHMARK()                                              \
+	{                                                                  \
+		memcpy_rectrotr_x(b2, b1,                                      \
+                          LINE_CNT, LINE_LEN,                          \
+                          LINE_CNT, LINE_LEN,                          \
+                          sizeof(b1[0]));                              \
+		UBENCH_DO_NOTHING(                                             \
+            memmove_rectflipv(b2, b2,                                  \
+                              LINE_LEN, LINE_CNT,                      \
+                              LINE_CNT, LINE_CNT,                      \
+                              sizeof(b1[0]))                           \
+        );                                                             \
+	}                                                                  \
+                                                                       \
+    free(b1);                                                          \
+    free(b2);
+
+UBENCH_EX(memcpy_rectorient, transpose_uint8_t)  { BENCH_MEMCPY_RECTORIENT_SIZE(MEMCPY_RECT_ORIENT_TRANSPOSE,   uint8_t, 2048, 2048); }
+UBENCH_EX(memcpy_rectorient, transpose_uint32_t) { BENCH_MEMCPY_RECTORIENT_SIZE(MEMCPY_RECT_ORIENT_TRANSPOSE,  uint32_t, 1024, 1024); }
+UBENCH_EX(memcpy_rectorient, transverse_uint32_t){ BENCH_MEMCPY_RECTORIENT_SIZE(MEMCPY_RECT_ORIENT_TRANSVERSE, uint32_t, 1024, 1024); }
+UBENCH_EX(memcpy_rectorient, chained_uint32_t)   { BENCH_MEMCPY_RECTORIENT_CHAINED_SIZE(uint32_t, 1024, 1024); }
 #endif
-// TODO: benchmark "uneven size items!"
 
 
-// over sizes ...
-#if 0
+///////////////////////////////////////////////////////////////
+//                          sweep                            //
+///////////////////////////////////////////////////////////////
+
+// all ops over sizes from 16b to 128MB to find the L1, L2, L3 and DRAM plateaus, only run when passing --sweep as it
+// takes a long time. Filter on op or kernel with --filter, i.e. --sweep --filter=sweep_memswap_*.sse2 ...
 #define BENCH_MEMSWAP_ALL(NAME, BUFSIZE)     \
     BENCH_MEMSWAP_SIZE(NAME, generic,         BUFSIZE) \
     BENCH_MEMSWAP_SIZE(NAME, memcpy,          BUFSIZE) \
@@ -265,9 +794,58 @@ UBENCH_EX(memmove_rectflipv, uint64_t) { BENCH_MEMMOVE_RECTFLIPV_SIZE(uint64_t,
     BENCH_MEMSWAP_SIZE(NAME, sse2_unroll,     BUFSIZE) \
     BENCH_MEMSWAP_SIZE(NAME, avx,             BUFSIZE) \
     BENCH_MEMSWAP_SIZE(NAME, avx_unroll,      BUFSIZE) \
+    BENCH_MEMSWAP_SIZE(NAME, avx512,          BUFSIZE) \
+    BENCH_MEMSWAP_SIZE(NAME, avx512_unroll,   BUFSIZE) \
+    BENCH_MEMSWAP_SIZE(NAME, sse2_stream,     BUFSIZE) \
+    BENCH_MEMSWAP_SIZE(NAME, avx_stream,      BUFSIZE) \
     BENCH_MEMSWAP_SIZE(NAME, std_swap_ranges, BUFSIZE) \
     BENCH_MEMSWAP_SIZE(NAME, memcpy_only,     BUFSIZE)
 
+// ... the rect-ops work on a square of uint32_t with BUFSIZE bytes in both src and dst, compared with a plain memcpy
+//     of the same square ...
+UBENCH_NOINLINE void sweep_memcpy_noinline          (uint32_t* dst, uint32_t* src, size_t side) { memcpy(dst, src, side * side * sizeof(uint32_t)); }
+UBENCH_NOINLINE void sweep_memcpy_rect_noinline     (uint32_t* dst, uint32_t* src, size_t side) { memcpy_rect(dst, src, side, side * sizeof(uint32_t), side * sizeof(uint32_t), side * sizeof(uint32_t)); }
+UBENCH_NOINLINE void sweep_memcpy_rectrotr_noinline (uint32_t* dst, uint32_t* src, size_t side) { memcpy_rectrotr_x(dst, src, side, side, side, side, sizeof(uint32_t)); }
+UBENCH_NOINLINE void sweep_memcpy_rectrotl_noinline (uint32_t* dst, uint32_t* src, size_t side) { memcpy_rectrotl_x(dst, src, side, side, side, side, sizeof(uint32_t)); }
+UBENCH_NOINLINE void sweep_memcpy_rectfliph_noinline(uint32_t* dst, uint32_t* src, size_t side) { memcpy_rectfliph(dst, src, side, side, side, side, sizeof(uint32_t)); }
+UBENCH_NOINLINE void sweep_memcpy_rectflipv_noinline(uint32_t* dst, uint32_t* src, size_t side) { memcpy_rectflipv(dst, src, side, side, side, side, sizeof(uint32_t)); }
+
+static size_t sweep_side(size_t bytes)
+{
+    size_t side = 1;
+    while((side + 1) * (side + 1) * sizeof(uint32_t) <= bytes)
+        ++side;
+    return side;
+}
+
+#define BENCH_SWEEP_RECT_SIZE(NAME, OP, BUFSIZE)                                \
+    UBENCH_EX(NAME, OP)                                                         \
+    {                                                                           \
+        const size_t side = sweep_side(BUFSIZE);                                \
+        uint32_t* b1 = alloc_random_buffer<uint32_t>(side * side);              \
+        uint32_t* b2 = alloc_random_buffer<uint32_t>(side * side);              \
+        clear_cache();                                                          \
+        UBENCH_SET_BYTES(side * side * sizeof(uint32_t) * 2);                   \
+        UBENCH_DO_BENCHMARK()                                                   \
+        {                                                                       \
+            sweep_##OP##_noinline(b2, b1, side);                                \
+        }                                                                       \
+        free(b1);                                                               \
+        free(b2);                                                               \
+    }
+
+#define BENCH_SWEEP_RECT_ALL(NAME, BUFSIZE)                 \
+    BENCH_SWEEP_RECT_SIZE(NAME, memcpy,           BUFSIZE) \
+    BENCH_SWEEP_RECT_SIZE(NAME, memcpy_rect,      BUFSIZE) \
+    BENCH_SWEEP_RECT_SIZE(NAME, memcpy_rectrotr,  BUFSIZE) \
+    BENCH_SWEEP_RECT_SIZE(NAME, memcpy_rectrotl,  BUFSIZE) \
+    BENCH_SWEEP_RECT_SIZE(NAME, memcpy_rectfliph, BUFSIZE) \
+    BENCH_SWEEP_RECT_SIZE(NAME, memcpy_rectflipv, BUFSIZE)
+
+#define BENCH_SWEEP_ALL(SIZE_NAME, BUFSIZE)                  \
+    BENCH_MEMSWAP_ALL(sweep_memswap_##SIZE_NAME, BUFSIZE)    \
+    BENCH_SWEEP_RECT_ALL(sweep_rect_##SIZE_NAME, BUFSIZE)
+
 size_t kb(size_t cnt)
 {
     return cnt * 1024llu;
@@ -278,50 +856,281 @@ size_t mb(size_t cnt)
     return cnt * 1024llu * 1024llu;
 }
 
-size_t gb(size_t cnt)
+BENCH_SWEEP_ALL(16b,    16)
+BENCH_SWEEP_ALL(32b,    32)
+BENCH_SWEEP_ALL(64b,    64)
+BENCH_SWEEP_ALL(128b,  128)
+BENCH_SWEEP_ALL(256b,  256)
+BENCH_SWEEP_ALL(512b,  512)
+BENCH_SWEEP_ALL(1kb,   kb(  1))
+BENCH_SWEEP_ALL(2kb,   kb(  2))
+BENCH_SWEEP_ALL(4kb,   kb(  4))
+BENCH_SWEEP_ALL(8kb,   kb(  8))
+BENCH_SWEEP_ALL(16kb,  kb( 16))
+BENCH_SWEEP_ALL(32kb,  kb( 32))
+BENCH_SWEEP_ALL(64kb,  kb( 64))
+BENCH_SWEEP_ALL(128kb, kb(128))
+BENCH_SWEEP_ALL(256kb, kb(256))
+BENCH_SWEEP_ALL(512kb, kb(512))
+BENCH_SWEEP_ALL(1MB,   mb(  1))
+BENCH_SWEEP_ALL(2MB,   mb(  2))
+BENCH_SWEEP_ALL(4MB,   mb(  4))
+BENCH_SWEEP_ALL(6MB,   mb(  6))
+BENCH_SWEEP_ALL(8MB,   mb(  8))
+BENCH_SWEEP_ALL(12MB,  mb( 12))
+BENCH_SWEEP_ALL(16MB,  mb( 16))
+BENCH_SWEEP_ALL(32MB,  mb( 32))
+BENCH_SWEEP_ALL(48MB,  mb( 48))
+BENCH_SWEEP_ALL(64MB,  mb( 64))
+BENCH_SWEEP_ALL(96MB,  mb( 96))
+BENCH_SWEEP_ALL(128MB, mb(128))
+
+///////////////////////////////////////////////////////////////
+//                      alignment sweep                      //
+///////////////////////////////////////////////////////////////
+
+// GB/s of each op for every combination of src and dst misalignment from 0 to 63 bytes, this covers all relative
+// offsets dst - src as well. Too many combinations to register as benchmarks so the sweep is run from main with
+// --align-sweep or --align-sweep=<op> and printed as one csv-table per op, a row per src-misalignment and a column
+// per dst-misalignment, i.e. ready to be loaded as a heatmap.
+// The ops work on ALIGN_SWEEP_BYTES in both src and dst to stay in L1 where misaligned loads and stores cost the most.
+// Rect-ops use a stride that is a multiple of 64 so that all lines share the same misalignment.
+static const size_t ALIGN_SWEEP_BYTES    = 16 * 1024;
+static const size_t ALIGN_SWEEP_LINELEN  = 512;
+static const size_t ALIGN_SWEEP_STRIDE   = ALIGN_SWEEP_LINELEN + 64;
+static const size_t ALIGN_SWEEP_LINECNT  = ALIGN_SWEEP_BYTES / ALIGN_SWEEP_LINELEN;
+static const size_t ALIGN_SWEEP_ITEMSIZE = 4;
+
+UBENCH_NOINLINE void align_sweep_memswap(uint8_t* dst, uint8_t* src)
 {
-    return cnt * 1024llu * 1024llu * 1024llu;
+    memswap(dst, src, ALIGN_SWEEP_BYTES);
 }
 
-BENCH_MEMSWAP_ALL(memswap_16b,    16)
-BENCH_MEMSWAP_ALL(memswap_32b,    32)
-BENCH_MEMSWAP_ALL(memswap_64b,    64)
-BENCH_MEMSWAP_ALL(memswap_128b,  128)
-BENCH_MEMSWAP_ALL(memswap_256b,  256)
-BENCH_MEMSWAP_ALL(memswap_512b,  512)
-BENCH_MEMSWAP_ALL(memswap_1kb,   kb(  1))
-BENCH_MEMSWAP_ALL(memswap_2kb,   kb(  2))
-BENCH_MEMSWAP_ALL(memswap_4kb,   kb(  4))
-BENCH_MEMSWAP_ALL(memswap_8kb,   kb(  8))
-BENCH_MEMSWAP_ALL(memswap_16kb,  kb( 16))
-BENCH_MEMSWAP_ALL(memswap_32kb,  kb( 32))
-BENCH_MEMSWAP_ALL(memswap_64kb,  kb( 64))
-BENCH_MEMSWAP_ALL(memswap_128kb, kb(128))
-BENCH_MEMSWAP_ALL(memswap_256kb, kb(256))
-BENCH_MEMSWAP_ALL(memswap_512kb, kb(512))
-BENCH_MEMSWAP_ALL(memswap_1MB,   mb(  1))
-BENCH_MEMSWAP_ALL(memswap_2MB,   mb(  2))
-BENCH_MEMSWAP_ALL(memswap_4MB,   mb(  4))
-BENCH_MEMSWAP_ALL(memswap_6MB,   mb(  6))
-BENCH_MEMSWAP_ALL(memswap_8MB,   mb(  8))
-BENCH_MEMSWAP_ALL(memswap_12MB,  mb( 12))
-BENCH_MEMSWAP_ALL(memswap_16MB,  mb( 16))
-BENCH_MEMSWAP_ALL(memswap_32MB,  mb( 32))
-BENCH_MEMSWAP_ALL(memswap_48MB,  mb( 48))
-BENCH_MEMSWAP_ALL(memswap_64MB,  mb( 64))
-BENCH_MEMSWAP_ALL(memswap_96MB,  mb( 96))
-BENCH_MEMSWAP_ALL(memswap_128MB, mb(128))
+UBENCH_NOINLINE void align_sweep_memcpy_rect(uint8_t* dst, uint8_t* src)
+{
+    memcpy_rect(dst, src, ALIGN_SWEEP_LINECNT, ALIGN_SWEEP_LINELEN, ALIGN_SWEEP_STRIDE, ALIGN_SWEEP_STRIDE);
+}
+
+UBENCH_NOINLINE void align_sweep_memcpy_rectfliph(uint8_t* dst, uint8_t* src)
+{
+    memcpy_rectfliph(dst, src,
+                     ALIGN_SWEEP_LINECNT, ALIGN_SWEEP_LINELEN / ALIGN_SWEEP_ITEMSIZE,
+                     ALIGN_SWEEP_STRIDE / ALIGN_SWEEP_ITEMSIZE, ALIGN_SWEEP_STRIDE / ALIGN_SWEEP_ITEMSIZE,
+                     ALIGN_SWEEP_ITEMSIZE);
+}
+
+UBENCH_NOINLINE void align_sweep_memcpy_rectflipv(uint8_t* dst, uint8_t* src)
+{
+    memcpy_rectflipv(dst, src,
+                     ALIGN_SWEEP_LINECNT, ALIGN_SWEEP_LINELEN / ALIGN_SWEEP_ITEMSIZE,
+                     ALIGN_SWEEP_STRIDE / ALIGN_SWEEP_ITEMSIZE, ALIGN_SWEEP_STRIDE / ALIGN_SWEEP_ITEMSIZE,
+                     ALIGN_SWEEP_ITEMSIZE);
+}
+
+struct align_sweep_op
+{
+    const char* name;
+    void (*func)(uint8_t* dst, uint8_t* src);
+    bool rect;
+};
+
+static const align_sweep_op ALIGN_SWEEP_OPS[] = {
+    { "memswap",          align_sweep_memswap,          false },
+    { "memcpy_rect",      align_sweep_memcpy_rect,      true  },
+    { "memcpy_rectfliph", align_sweep_memcpy_rectfliph, true  },
+    { "memcpy_rectflipv", align_sweep_memcpy_rectflipv, true  },
+};
+
+static void align_sweep(const align_sweep_op& op)
+{
+    const size_t buf_size = (op.rect ? ALIGN_SWEEP_LINECNT * ALIGN_SWEEP_STRIDE : ALIGN_SWEEP_BYTES) + 64;
+    uint8_t* src_alloc = alloc_random_buffer<uint8_t>(buf_size + 64);
+    uint8_t* dst_alloc = alloc_random_buffer<uint8_t>(buf_size + 64);
+    uint8_t* src_base  = (uint8_t*)(((uintptr_t)src_alloc + 63) & ~(uintptr_t)63);
+    uint8_t* dst_base  = (uint8_t*)(((uintptr_t)dst_alloc + 63) & ~(uintptr_t)63);
+
+    // ... bytes read + written per call, as for the other benchmarks ...
+    const double bytes = (double)(ALIGN_SWEEP_BYTES * 2);
+
+    printf("# %s, GB/s, rows: src misalignment, columns: dst misalignment\n", op.name);
+    printf("src\\dst");
+    for(int dst_align = 0; dst_align < 64; ++dst_align)
+        printf(", %d", dst_align);
+    printf("\n");
+
+    for(int src_align = 0; src_align < 64; ++src_align)
+    {
+        printf("%d", src_align);
+        for(int dst_align = 0; dst_align < 64; ++dst_align)
+        {
+            uint8_t* src = src_base + src_align;
+            uint8_t* dst = dst_base + dst_align;
+
+            // ... the fastest of a few batches, to filter out interrupts and other noise ...
+            op.func(dst, src);
+            ubench_int64_t best = INT64_MAX;
+            for(int batch = 0; batch < 8; ++batch)
+            {
+                const ubench_int64_t start = ubench_ns();
+                for(int call = 0; call < 8; ++call)
+                    op.func(dst, src);
+                const ubench_int64_t ns = (ubench_ns() - start) / 8;
+                best = ns < best ? ns : best;
+            }
+            printf(", %.2f", best > 0 ? bytes / (double)best : 0.0);
+        }
+        printf("\n");
+    }
+    printf("\n");
+
+    free(src_alloc);
+    free(dst_alloc);
+}
+
+// run the alignment sweep for all ops or the op passed as --align-sweep=<op>, false if op is unknown.
+static bool align_sweep(const char* op_name)
+{
+    bool found = false;
+    for(size_t i = 0; i < sizeof(ALIGN_SWEEP_OPS) / sizeof(ALIGN_SWEEP_OPS[0]); ++i)
+    {
+        if(op_name != nullptr && strcmp(op_name, ALIGN_SWEEP_OPS[i].name) != 0)
+            continue;
+        align_sweep(ALIGN_SWEEP_OPS[i]);
+        found = true;
+    }
+    return found;
+}
+
+// drop all benchmarks which name start with prefix from the ubench-state, with kernel_prefix only the ones where the
+// part after the '.', i.e. the memswap-kernel in memswap_big.avx512_unroll, also start with kernel_prefix.
+static void remove_benchmarks(const char* prefix, const char* kernel_prefix = nullptr)
+{
+    size_t kept = 0;
+    for(size_t i = 0; i < ubench_state.benchmarks_length; ++i)
+    {
+        const char* name   = ubench_state.benchmarks[i].name;
+        const char* kernel = strchr(name, '.');
+        if(strncmp(name, prefix, strlen(prefix)) == 0 &&
+           (kernel_prefix == nullptr || (kernel && strncmp(kernel + 1, kernel_prefix, strlen(kernel_prefix)) == 0)))
+        {
+            free(ubench_state.benchmarks[i].name);
+            continue;
+        }
+        ubench_state.benchmarks[kept++] = ubench_state.benchmarks[i];
+    }
+    ubench_state.benchmarks_length = kept;
+}
+
+// cpu model as reported by the os, "unknown" if not available.
+static const char* cpu_model_name()
+{
+    static char model[256] = "unknown";
+#if defined(__linux__)
+    FILE* cpuinfo = fopen("/proc/cpuinfo", "r");
+    if(cpuinfo == nullptr)
+        return model;
+
+    char line[512];
+    while(fgets(line, sizeof(line), cpuinfo))
+    {
+        if(strncmp(line, "model name", 10) != 0)
+            continue;
+
+        const char* value = strchr(line, ':');
+        if(value == nullptr)
+            continue;
+        value += strspn(value, ": \t");
+        snprintf(model, sizeof(model), "%.*s", (int)strcspn(value, "\n"), value);
+        break;
+    }
+    fclose(cpuinfo);
 #endif
+    return model;
+}
 
 UBENCH_STATE();
 
 int main(int argc, const char *const argv[])
 {
+    // ... describe the build and machine so that results from --output and --json can be compared ...
 #if defined(__clang__)
-    printf("Clang " __VERSION__ "\n");
+    ubench_add_context("compiler", "Clang " __VERSION__);
 #elif defined(__GNUC__)
-    printf("GCC " __VERSION__ "\n");
+    ubench_add_context("compiler", "GCC " __VERSION__);
+#endif
+    ubench_add_context("cpu", cpu_model_name());
+    static const char isa_compiled[] = ""
+#if defined(__SSE2__)
+        " sse2"
 #endif
+#if defined(__SSSE3__)
+        " ssse3"
+#endif
+#if defined(__AVX__)
+        " avx"
+#endif
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+        " avx512"
+#endif
+        ;
+    ubench_add_context("isa compiled", isa_compiled[0] ? isa_compiled + 1 : "none");
+    ubench_add_context("isa cpu", memcpy_util_has_avx512() ? "sse2 avx avx512"
+                                : memcpy_util_has_avx()    ? "sse2 avx"
+                                : memcpy_util_has_sse2()   ? "sse2"
+                                : "none");
+
+    // ... allow pinning the kernel used by memswap() and all functions using it, --memswap-kernel=sse2_unroll ...
+    const char memswap_kernel_str[] = "--memswap-kernel=";
+    for(int i = 1; i < argc; ++i)
+    {
+        if(strncmp(argv[i], memswap_kernel_str, sizeof(memswap_kernel_str) - 1) != 0)
+            continue;
+
+        const char* name = argv[i] + sizeof(memswap_kernel_str) - 1;
+        int k = 0;
+        for(; k < MEMSWAP_KERNEL_COUNT; ++k)
+            if(strcmp(name, memswap_kernel_name((memswap_kernel)k)) == 0)
+                break;
+
+        if(k == MEMSWAP_KERNEL_COUNT || !memswap_set_kernel((memswap_kernel)k))
+        {
+            printf("memswap kernel \"%s\" is unknown or not supported on this cpu\n", name);
+            return 1;
+        }
+    }
+    ubench_add_context("memswap kernel", memswap_kernel_name(memswap_get_kernel()));
+
+    // ... --align-sweep replaces the normal benchmarks ...
+    const char align_sweep_str[] = "--align-sweep";
+    for(int i = 1; i < argc; ++i)
+    {
+        if(strncmp(argv[i], align_sweep_str, sizeof(align_sweep_str) - 1) != 0)
+            continue;
+
+        const char* op = argv[i][sizeof(align_sweep_str) - 1] == '=' ? argv[i] + sizeof(align_sweep_str) : nullptr;
+        for(size_t c = 0; c < ubench_state.context_length; ++c)
+            printf("# %s: %s\n", ubench_state.context[c][0], ubench_state.context[c][1]);
+        if(!align_sweep(op))
+        {
+            printf("unknown --align-sweep op \"%s\"\n", op);
+            return 1;
+        }
+        return 0;
+    }
+
+    // ... the size-sweep is only run with --sweep ...
+    bool sweep = false;
+    for(int i = 1; i < argc; ++i)
+        sweep |= strcmp(argv[i], "--sweep") == 0;
+    if(!sweep)
+        remove_benchmarks("sweep_");
+
+    // ... memswap-kernels the cpu can't run would die on an illegal instruction ...
+    if(!memcpy_util_has_avx())
+        remove_benchmarks("", "avx");
+    else if(!memcpy_util_has_avx512())
+        remove_benchmarks("", "avx512");
+
     srand(1337);
     return ubench_main(argc, argv);
 }
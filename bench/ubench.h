@@ -141,6 +141,20 @@ UBENCH_C_FUNC __declspec(dllimport) int __stdcall QueryPerformanceFrequency(uben
 #include <mach/mach_time.h>
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+/* _mm_clflush() for --cache=cold */
+#include <emmintrin.h>
+#define UBENCH_HAS_CLFLUSH
+#endif
+
+#if defined(__linux__)
+/* hardware performance counters, see ubench_perf_open() */
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 #if defined(__cplusplus)
 #define UBENCH_C_FUNC extern "C"
 #else
@@ -273,10 +287,53 @@ static UBENCH_INLINE ubench_int64_t ubench_ns(void) {
 #endif
 }
 
+/*
+   hardware counters sampled around UBENCH_DO_BENCHMARK() when running with
+   --perf, see ubench_perf_open().
+*/
+enum ubench_perf_counter_e {
+  UBENCH_PERF_CYCLES,
+  UBENCH_PERF_INSTRUCTIONS,
+  UBENCH_PERF_L1D_MISSES,
+  UBENCH_PERF_LLC_MISSES,
+  UBENCH_PERF_DTLB_MISSES,
+  UBENCH_PERF_BRANCH_MISSES,
+  UBENCH_PERF_COUNTER_COUNT
+};
+
+/* max number of ubench_add_context() entries */
+#define UBENCH_MAX_CONTEXT 16
+
+/* max number of ubench_cache_range() entries per benchmark */
+#define UBENCH_MAX_CACHE_RANGES 8
+
+/* how the caches are prepared before each sample, see --cache= */
+enum ubench_cache_mode_e {
+  /* the default, nothing is evicted and there is no warm-up iteration */
+  UBENCH_CACHE_NONE,
+  /* nothing is evicted, one untimed iteration warms up the caches */
+  UBENCH_CACHE_HOT,
+  /* L1 and L2 are evicted before each sample but data stays in the LLC */
+  UBENCH_CACHE_WARM_LLC,
+  /* the benchmark memory is evicted from all caches before each sample */
+  UBENCH_CACHE_COLD
+};
+
 struct ubench_run_state_s {
   ubench_int64_t* ns;
   ubench_int64_t  size;
   ubench_int64_t  sample;
+  ubench_int64_t  bytes;
+  /* counter totals over all samples of the run, -1 if not available */
+  ubench_int64_t  perf[UBENCH_PERF_COUNTER_COUNT];
+  /* time spent preparing caches between samples, not part of ns */
+  ubench_int64_t  paused;
+  /* non-zero until the warm-up iteration has run */
+  int             warmup;
+  /* memory the benchmark works on, see ubench_cache_range() */
+  const void*     cache_ranges[UBENCH_MAX_CACHE_RANGES];
+  size_t          cache_range_sizes[UBENCH_MAX_CACHE_RANGES];
+  size_t          cache_ranges_length;
 };
 
 typedef void (*ubench_benchmark_t)(struct ubench_run_state_s* ubs);
@@ -291,6 +348,19 @@ struct ubench_state_s {
   size_t benchmarks_length;
   FILE *output;
   double confidence;
+  /* non-zero if any hardware counter could be opened, see --perf */
+  int perf;
+  int perf_fds[UBENCH_PERF_COUNTER_COUNT];
+  FILE *json;
+  /* key/value pairs describing the run, see ubench_add_context() */
+  const char *context[UBENCH_MAX_CONTEXT][2];
+  size_t context_length;
+  int cache_mode;
+  /* buffer read to evict other data from the caches, see --cache= */
+  unsigned char *evict;
+  size_t evict_size;
+  /* the benchmark currently running */
+  struct ubench_run_state_s *run;
 };
 
 /* extern to the global state ubench needs to execute */
@@ -332,16 +402,257 @@ UBENCH_EXTERN struct ubench_state_s ubench_state;
 #pragma clang diagnostic pop
 #endif
 
+static const char *const ubench_perf_counter_names[UBENCH_PERF_COUNTER_COUNT] =
+    {"cycles",     "instructions", "L1D misses",
+     "LLC misses", "dTLB misses",  "branch misses"};
+
+#if defined(__linux__)
+/*
+   Open one perf_event per counter for the calling thread, user space only.
+   Counters are opened one by one rather than as a group so that a counter the
+   cpu or kernel refuses (virtual machines, perf_event_paranoid) only drops
+   that counter. Returns the number of counters opened.
+*/
+static UBENCH_INLINE int ubench_perf_open(void) {
+  static const ubench_uint64_t cache_read_miss =
+      (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+  const unsigned types[UBENCH_PERF_COUNTER_COUNT] = {
+      PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+      PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HARDWARE};
+  const ubench_uint64_t configs[UBENCH_PERF_COUNTER_COUNT] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_L1D | cache_read_miss,
+      PERF_COUNT_HW_CACHE_MISSES,
+      PERF_COUNT_HW_CACHE_DTLB | cache_read_miss,
+      PERF_COUNT_HW_BRANCH_MISSES};
+  int opened = 0;
+  int counter;
+
+  for (counter = 0; counter < UBENCH_PERF_COUNTER_COUNT; counter++) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = types[counter];
+    attr.size = sizeof(attr);
+    attr.config = configs[counter];
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    /* the pmu might be shared between more counters than it has, so read the
+       times to scale the result */
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    ubench_state.perf_fds[counter] = UBENCH_CAST(
+        int, syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    if (ubench_state.perf_fds[counter] >= 0) {
+      opened++;
+    }
+  }
+
+  ubench_state.perf = opened > 0;
+  return opened;
+}
+
+static UBENCH_INLINE void ubench_perf_close(void) {
+  int counter;
+  for (counter = 0; ubench_state.perf && counter < UBENCH_PERF_COUNTER_COUNT;
+       counter++) {
+    if (ubench_state.perf_fds[counter] >= 0) {
+      close(ubench_state.perf_fds[counter]);
+    }
+  }
+  ubench_state.perf = 0;
+}
+
+static UBENCH_INLINE void ubench_perf_start(void) {
+  int counter;
+  for (counter = 0; ubench_state.perf && counter < UBENCH_PERF_COUNTER_COUNT;
+       counter++) {
+    if (ubench_state.perf_fds[counter] >= 0) {
+      ioctl(ubench_state.perf_fds[counter], PERF_EVENT_IOC_RESET, 0);
+      ioctl(ubench_state.perf_fds[counter], PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+/* stop counting while ubench itself is working between samples */
+static UBENCH_INLINE void ubench_perf_pause(int pause) {
+  int counter;
+  for (counter = 0; ubench_state.perf && counter < UBENCH_PERF_COUNTER_COUNT;
+       counter++) {
+    if (ubench_state.perf_fds[counter] >= 0) {
+      ioctl(ubench_state.perf_fds[counter],
+            pause ? PERF_EVENT_IOC_DISABLE : PERF_EVENT_IOC_ENABLE, 0);
+    }
+  }
+}
+
+static UBENCH_INLINE void ubench_perf_stop(ubench_int64_t *totals) {
+  int counter;
+  for (counter = 0; counter < UBENCH_PERF_COUNTER_COUNT; counter++) {
+    totals[counter] = -1;
+  }
+
+  for (counter = 0; ubench_state.perf && counter < UBENCH_PERF_COUNTER_COUNT;
+       counter++) {
+    /* value, time enabled, time running */
+    ubench_uint64_t values[3];
+    const int fd = ubench_state.perf_fds[counter];
+    if (fd < 0) {
+      continue;
+    }
+
+    ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(fd, values, sizeof(values)) == UBENCH_CAST(ssize_t, sizeof(values)) &&
+        values[2] > 0) {
+      totals[counter] = UBENCH_CAST(
+          ubench_int64_t, UBENCH_CAST(double, values[0]) *
+                              UBENCH_CAST(double, values[1]) /
+                              UBENCH_CAST(double, values[2]));
+    }
+  }
+}
+#else
+static UBENCH_INLINE int ubench_perf_open(void) { return 0; }
+static UBENCH_INLINE void ubench_perf_close(void) {}
+static UBENCH_INLINE void ubench_perf_start(void) {}
+static UBENCH_INLINE void ubench_perf_pause(int pause) { (void)pause; }
+static UBENCH_INLINE void ubench_perf_stop(ubench_int64_t *totals) {
+  int counter;
+  for (counter = 0; counter < UBENCH_PERF_COUNTER_COUNT; counter++) {
+    totals[counter] = -1;
+  }
+}
+#endif
+
+/*
+   Register memory used by the current benchmark, with --cache=cold it is
+   flushed from all caches before each sample. Call this during setup, before
+   UBENCH_DO_BENCHMARK(), the memory must stay valid until the loop ends.
+*/
+static UBENCH_INLINE void ubench_cache_range(const void *ptr, size_t size) {
+  struct ubench_run_state_s *ubs = ubench_state.run;
+  if (ubs && ubs->cache_ranges_length < UBENCH_MAX_CACHE_RANGES) {
+    ubs->cache_ranges[ubs->cache_ranges_length] = ptr;
+    ubs->cache_range_sizes[ubs->cache_ranges_length] = size;
+    ubs->cache_ranges_length++;
+  }
+}
+
+/* size of a cache level in bytes as reported by the os, or fallback */
+static UBENCH_INLINE size_t ubench_cache_size(int level, size_t fallback) {
+  long size = 0;
+#if defined(_SC_LEVEL2_CACHE_SIZE) && defined(_SC_LEVEL3_CACHE_SIZE)
+  size = sysconf(level == 2 ? _SC_LEVEL2_CACHE_SIZE : _SC_LEVEL3_CACHE_SIZE);
+#else
+  (void)level;
+#endif
+  return size > 0 ? UBENCH_CAST(size_t, size) : fallback;
+}
+
+/*
+   Allocate the eviction buffer for the cache mode, twice the size of the
+   cache that should be emptied. It is written once so that every page is
+   backed by its own memory and not the shared zero-page.
+*/
+static UBENCH_INLINE int ubench_cache_open(int mode) {
+  ubench_state.cache_mode = mode;
+  if (mode == UBENCH_CACHE_NONE || mode == UBENCH_CACHE_HOT) {
+    return 1;
+  }
+
+  ubench_state.evict_size =
+      2 * (mode == UBENCH_CACHE_COLD ? ubench_cache_size(3, 32 * 1024 * 1024)
+                                     : ubench_cache_size(2, 1024 * 1024));
+  ubench_state.evict = UBENCH_PTR_CAST(unsigned char *,
+                                       malloc(ubench_state.evict_size));
+  if (!ubench_state.evict) {
+    return 0;
+  }
+  memset(ubench_state.evict, 1, ubench_state.evict_size);
+  return 1;
+}
+
+static UBENCH_INLINE void ubench_cache_close(void) {
+  free(ubench_state.evict);
+  ubench_state.evict = UBENCH_NULL;
+  ubench_state.evict_size = 0;
+}
+
+static UBENCH_INLINE void ubench_cache_prepare(struct ubench_run_state_s *ubs) {
+  const volatile unsigned char *evict = ubench_state.evict;
+  size_t index;
+
+#if defined(UBENCH_HAS_CLFLUSH)
+  /* cold with known memory, flushing only that is way cheaper than reading
+     through a buffer twice the size of the LLC */
+  if (ubench_state.cache_mode == UBENCH_CACHE_COLD &&
+      ubs->cache_ranges_length > 0) {
+    for (index = 0; index < ubs->cache_ranges_length; index++) {
+      const char *ptr = UBENCH_PTR_CAST(const char *, ubs->cache_ranges[index]);
+      const char *end = ptr + ubs->cache_range_sizes[index];
+      for (; ptr < end; ptr += 64) {
+        _mm_clflush(ptr);
+      }
+      if (ubs->cache_range_sizes[index] > 0) {
+        _mm_clflush(end - 1);
+      }
+    }
+    _mm_mfence();
+    return;
+  }
+#else
+  (void)ubs;
+#endif
+
+  /* reading clean lines evicts the benchmark data, writing here would just
+     move the cost into the next sample as dirty write-backs */
+  for (index = 0; index < ubench_state.evict_size; index += 64) {
+    (void)evict[index];
+  }
+}
+
 static UBENCH_INLINE int ubench_do_benchmark(struct ubench_run_state_s* ubs)
 {
-  ubench_int64_t curr_sample = ubs->sample++;
-  ubs->ns[curr_sample] = ubench_ns();
-  return curr_sample < ubs->size ? 1 : 0;
+  ubench_int64_t curr_sample;
+  ubench_int64_t now;
+
+  if (ubs->warmup) {
+    ubs->warmup = 0;
+    return 1;
+  }
+
+  curr_sample = ubs->sample++;
+  /* counters only cover the measured loop, not the setup before it */
+  if (curr_sample == 0) {
+    ubs->paused = 0;
+    ubench_perf_start();
+  }
+  now = ubench_ns();
+  ubs->ns[curr_sample] = now - ubs->paused;
+  if (curr_sample < ubs->size) {
+    if (ubench_state.cache_mode == UBENCH_CACHE_WARM_LLC ||
+        ubench_state.cache_mode == UBENCH_CACHE_COLD) {
+      ubench_perf_pause(1);
+      ubench_cache_prepare(ubs);
+      ubench_perf_pause(0);
+      ubs->paused += ubench_ns() - now;
+    }
+    return 1;
+  }
+  ubench_perf_stop(ubs->perf);
+  return 0;
 }
 
 #define UBENCH_DO_BENCHMARK()                                                  \
   while(ubench_do_benchmark(ubench_run_state) > 0)
 
+/* set the number of bytes processed per iteration, used to report GB/s */
+#define UBENCH_SET_BYTES(BYTES)                                                \
+  ubench_run_state->bytes = UBENCH_CAST(ubench_int64_t, BYTES)
+
 #define UBENCH_EX(SET, NAME)                                                   \
   UBENCH_EXTERN struct ubench_state_s ubench_state;                            \
   static void ubench_##SET##_##NAME(struct ubench_run_state_s* ubs);           \
@@ -512,6 +823,213 @@ static UBENCH_INLINE FILE *ubench_fopen(const char *filename,
 #endif
 }
 
+/*
+   Describe the run, i.e. compiler, cpu model or what code-paths are selected.
+   The context is printed before running the benchmarks and is written to the
+   --output and --json files so that results from different machines and
+   builds can be told apart. key and value are not copied and need to stay
+   alive until ubench_main() returns.
+*/
+static UBENCH_INLINE void ubench_add_context(const char *key,
+                                             const char *value) {
+  if (ubench_state.context_length < UBENCH_MAX_CONTEXT) {
+    ubench_state.context[ubench_state.context_length][0] = key;
+    ubench_state.context[ubench_state.context_length][1] = value;
+    ubench_state.context_length++;
+  }
+}
+
+static UBENCH_INLINE void ubench_json_string(FILE *file, const char *str) {
+  fputc('"', file);
+  for (; *str; ++str) {
+    if (*str == '"' || *str == '\\') {
+      fputc('\\', file);
+    }
+    if (UBENCH_CAST(unsigned char, *str) >= 0x20) {
+      fputc(*str, file);
+    }
+  }
+  fputc('"', file);
+}
+
+struct ubench_result_s {
+  char name[256];
+  double mean_ns;
+  double confidence;
+};
+
+/*
+   Parse one benchmark line of a --json file, {"name": "...", "mean_ns": ...},
+   into result. Returns 0 if the line is not a benchmark.
+*/
+static UBENCH_INLINE int ubench_read_json_result(const char *line,
+                                                 struct ubench_result_s *result) {
+  const char *name = strstr(line, "{\"name\": \"");
+  const char *mean = strstr(line, "\"mean_ns\": ");
+  const char *confidence = strstr(line, "\"confidence_pct\": ");
+  size_t name_len = 0;
+
+  if (!name || !mean || !confidence) {
+    return 0;
+  }
+
+  /* undo the escapes written by ubench_json_string() */
+  for (name += strlen("{\"name\": \""); *name && *name != '"'; ++name) {
+    if (*name == '\\' && name[1]) {
+      ++name;
+    }
+    if (name_len < sizeof(result->name) - 1) {
+      result->name[name_len++] = *name;
+    }
+  }
+  result->name[name_len] = '\0';
+
+  result->mean_ns = strtod(mean + strlen("\"mean_ns\": "), UBENCH_NULL);
+  result->confidence =
+      strtod(confidence + strlen("\"confidence_pct\": "), UBENCH_NULL);
+  return 1;
+}
+
+/*
+   Read the results of an --output csv-file or a --json file, a file starting
+   with '{' is read as json. In csv-files lines starting with '#' are context
+   and are skipped. Returns the number of results or -1 if the file could not
+   be opened, the result array should be freed by the caller.
+*/
+static UBENCH_INLINE long ubench_read_results(const char *filename,
+                                              struct ubench_result_s **out) {
+  FILE *file = ubench_fopen(filename, "r");
+  struct ubench_result_s *results = UBENCH_NULL;
+  long count = 0;
+  int json = -1;
+  char line[4096];
+
+  *out = UBENCH_NULL;
+  if (!file) {
+    return -1;
+  }
+
+  while (fgets(line, sizeof(line), file)) {
+    struct ubench_result_s *result;
+    struct ubench_result_s json_result;
+    char *end = strchr(line, ',');
+    size_t name_len;
+
+    if (json < 0) {
+      json = line[0] == '{';
+    }
+
+    if (json) {
+      if (!ubench_read_json_result(line, &json_result)) {
+        continue;
+      }
+      results = UBENCH_PTR_CAST(
+          struct ubench_result_s *,
+          realloc(UBENCH_PTR_CAST(void *, results),
+                  sizeof(struct ubench_result_s) *
+                      UBENCH_CAST(size_t, count + 1)));
+      results[count++] = json_result;
+      continue;
+    }
+
+    if (line[0] == '#' || !end ||
+        0 == ubench_strncmp(line, "name,", strlen("name,"))) {
+      continue;
+    }
+
+    results = UBENCH_PTR_CAST(
+        struct ubench_result_s *,
+        realloc(UBENCH_PTR_CAST(void *, results),
+                sizeof(struct ubench_result_s) * UBENCH_CAST(size_t, count + 1)));
+    result = &results[count++];
+
+    name_len = UBENCH_CAST(size_t, end - line);
+    name_len = name_len < sizeof(result->name) - 1 ? name_len
+                                                   : sizeof(result->name) - 1;
+    memcpy(result->name, line, name_len);
+    result->name[name_len] = '\0';
+
+    /* mean, stddev, confidence */
+    result->mean_ns = strtod(end + 1, &end);
+    strtod(end + 1, &end);
+    result->confidence = strtod(end + 1, &end);
+  }
+
+  fclose(file);
+  *out = results;
+  return count;
+}
+
+/*
+   Compare the results of two --output or --json files and report every benchmark that
+   changed more than threshold percent. A change is only reported as a
+   regression or improvement if the difference is significant at the 99%
+   level, the standard error of each mean is recovered from the reported
+   confidence interval. Returns the number of regressions or -1 on error.
+*/
+static UBENCH_INLINE long ubench_compare(const char *base_file,
+                                         const char *curr_file,
+                                         double threshold) {
+  struct ubench_result_s *base;
+  struct ubench_result_s *curr;
+  const long base_count = ubench_read_results(base_file, &base);
+  const long curr_count = ubench_read_results(curr_file, &curr);
+  long regressions = 0;
+  long index;
+
+  if (base_count < 0 || curr_count < 0) {
+    fprintf(stderr, "Failed to read results from \"%s\"\n",
+            base_count < 0 ? base_file : curr_file);
+    free(UBENCH_PTR_CAST(void *, base));
+    free(UBENCH_PTR_CAST(void *, curr));
+    return -1;
+  }
+
+  for (index = 0; index < curr_count; index++) {
+    const struct ubench_result_s *c = &curr[index];
+    const struct ubench_result_s *b = UBENCH_NULL;
+    const char *status = "[   SAME   ]";
+    double change, base_se, curr_se, z;
+    long bndex;
+
+    for (bndex = 0; bndex < base_count && !b; bndex++) {
+      if (0 == strcmp(base[bndex].name, c->name)) {
+        b = &base[bndex];
+      }
+    }
+
+    if (!b || b->mean_ns <= 0) {
+      printf("[   NEW    ] %s\n", c->name);
+      continue;
+    }
+
+    /* confidence is 2.576 * stderr relative to the mean, in percent */
+    base_se = b->confidence / 100.0 * b->mean_ns / 2.576;
+    curr_se = c->confidence / 100.0 * c->mean_ns / 2.576;
+    z = (c->mean_ns - b->mean_ns) /
+        sqrt(base_se * base_se + curr_se * curr_se + 1e-9);
+    change = (c->mean_ns - b->mean_ns) / b->mean_ns * 100.0;
+
+    if (change > threshold && z > 2.576) {
+      status = "[  SLOWER  ]";
+      regressions++;
+    } else if (change < -threshold && z < -2.576) {
+      status = "[  FASTER  ]";
+    }
+
+    printf("%s %s (%.0fns -> %.0fns, %+.2f%%)\n", status, c->name, b->mean_ns,
+           c->mean_ns, change);
+  }
+
+  printf("[==========] %ld benchmarks compared, %ld significant regressions "
+         "over %.2f%%.\n",
+         curr_count, regressions, threshold);
+
+  free(UBENCH_PTR_CAST(void *, base));
+  free(UBENCH_PTR_CAST(void *, curr));
+  return regressions;
+}
+
 static UBENCH_INLINE int ubench_main(int argc, const char *const argv[]);
 int ubench_main(int argc, const char *const argv[]) {
   ubench_uint64_t failed = 0;
@@ -519,6 +1037,9 @@ int ubench_main(int argc, const char *const argv[]) {
   size_t *failed_benchmarks = UBENCH_NULL;
   size_t failed_benchmarks_length = 0;
   const char *filter = UBENCH_NULL;
+  const char *compare = UBENCH_NULL;
+  double compare_threshold = 2.0;
+  size_t json_benchmarks = 0;
   ubench_uint64_t ran_benchmarks = 0;
 
   enum colours { RESET, GREEN, RED };
@@ -540,6 +1061,11 @@ int ubench_main(int argc, const char *const argv[]) {
     const char filter_str[] = "--filter=";
     const char output_str[] = "--output=";
     const char confidence_str[] = "--confidence=";
+    const char perf_str[] = "--perf";
+    const char json_str[] = "--json=";
+    const char compare_str[] = "--compare=";
+    const char threshold_str[] = "--compare-threshold=";
+    const char cache_str[] = "--cache=";
 
     if (0 == ubench_strncmp(argv[index], help_str, strlen(help_str))) {
       printf("ubench.h - the single file benchmarking solution for C/C++!\n"
@@ -551,7 +1077,18 @@ int ubench_main(int argc, const char *const argv[]) {
              "Output names can be passed to --filter.\n"
              "  --output=<output>         Output a CSV file of the results.\n"
              "  --confidence=<confidence> Change the confidence cut-off for a "
-             "failed test. Defaults to 2.5%%\n");
+             "failed test. Defaults to 2.5%%\n"
+             "  --perf                    Also report hardware performance "
+             "counters per iteration (Linux only).\n"
+             "  --json=<output>           Output a JSON file of the results.\n"
+             "  --compare=<base>,<new>    Compare two CSV or JSON files written "
+             "by --output or --json instead of running benchmarks, fails on "
+             "significant regressions.\n"
+             "  --compare-threshold=<pct> Ignore changes smaller than this. "
+             "Defaults to 2%%\n"
+             "  --cache=<mode>            none, hot, warm-llc or cold. State "
+             "of the caches at the start of each sample, hot adds an untimed "
+             "warm-up iteration. Defaults to none.\n");
       goto cleanup;
     } else if (0 ==
                ubench_strncmp(argv[index], filter_str, strlen(filter_str))) {
@@ -580,9 +1117,72 @@ int ubench_main(int argc, const char *const argv[]) {
                 ubench_state.confidence);
         goto cleanup;
       }
+    } else if (0 == ubench_strncmp(argv[index], perf_str, strlen(perf_str))) {
+      if (0 == ubench_perf_open()) {
+        fprintf(stderr, "No hardware performance counters available, check "
+                        "/proc/sys/kernel/perf_event_paranoid\n");
+      }
+    } else if (0 == ubench_strncmp(argv[index], json_str, strlen(json_str))) {
+      ubench_state.json = ubench_fopen(argv[index] + strlen(json_str), "w+");
+    } else if (0 == ubench_strncmp(argv[index], compare_str,
+                                   strlen(compare_str))) {
+      compare = argv[index] + strlen(compare_str);
+    } else if (0 == ubench_strncmp(argv[index], threshold_str,
+                                   strlen(threshold_str))) {
+      compare_threshold = atof(argv[index] + strlen(threshold_str));
+    } else if (0 ==
+               ubench_strncmp(argv[index], cache_str, strlen(cache_str))) {
+      const char *const modes[] = {"none", "hot", "warm-llc", "cold"};
+      int mode = 0;
+      while (mode < 4 && 0 != strcmp(argv[index] + strlen(cache_str),
+                                     modes[mode])) {
+        mode++;
+      }
+
+      if (mode == 4 || !ubench_cache_open(mode)) {
+        fprintf(stderr, "Unknown or unsupported cache mode \"%s\"\n",
+                argv[index] + strlen(cache_str));
+        failed = 1;
+        goto cleanup;
+      }
     }
   }
 
+  ubench_add_context("cache", ubench_state.cache_mode == UBENCH_CACHE_COLD
+                                  ? "cold"
+                              : ubench_state.cache_mode == UBENCH_CACHE_WARM_LLC
+                                  ? "warm-llc"
+                              : ubench_state.cache_mode == UBENCH_CACHE_HOT
+                                  ? "hot"
+                                  : "none");
+
+  if (compare) {
+    char base_file[1024];
+    const char *curr_file = strchr(compare, ',');
+    long regressions;
+    size_t base_len;
+
+    if (!curr_file) {
+      fprintf(stderr, "--compare expects two files, --compare=<base>,<new>\n");
+      failed = 1;
+      goto cleanup;
+    }
+
+    base_len = UBENCH_CAST(size_t, curr_file - compare);
+    base_len = base_len < sizeof(base_file) - 1 ? base_len : sizeof(base_file) - 1;
+    memcpy(base_file, compare, base_len);
+    base_file[base_len] = '\0';
+
+    regressions = ubench_compare(base_file, curr_file + 1, compare_threshold);
+    failed = regressions != 0 ? 1 : 0;
+    goto cleanup;
+  }
+
+  for (index = 0; index < ubench_state.context_length; index++) {
+    printf("%s: %s\n", ubench_state.context[index][0],
+           ubench_state.context[index][1]);
+  }
+
   for (index = 0; index < ubench_state.benchmarks_length; index++) {
     if (ubench_should_filter(filter, ubench_state.benchmarks[index].name)) {
       continue;
@@ -596,8 +1196,30 @@ int ubench_main(int argc, const char *const argv[]) {
          UBENCH_CAST(ubench_uint64_t, ran_benchmarks));
 
   if (ubench_state.output) {
+    for (index = 0; index < ubench_state.context_length; index++) {
+      fprintf(ubench_state.output, "# %s: %s\n",
+              ubench_state.context[index][0], ubench_state.context[index][1]);
+    }
     fprintf(ubench_state.output,
-            "name, mean (ns), stddev (%%), confidence (%%)\n");
+            "name, mean (ns), stddev (%%), confidence (%%), bytes, GB/s");
+    if (ubench_state.perf) {
+      size_t counter;
+      for (counter = 0; counter < UBENCH_PERF_COUNTER_COUNT; counter++) {
+        fprintf(ubench_state.output, ", %s", ubench_perf_counter_names[counter]);
+      }
+    }
+    fprintf(ubench_state.output, "\n");
+  }
+
+  if (ubench_state.json) {
+    fprintf(ubench_state.json, "{\n  \"context\": {");
+    for (index = 0; index < ubench_state.context_length; index++) {
+      fprintf(ubench_state.json, "%s\n    ", index ? "," : "");
+      ubench_json_string(ubench_state.json, ubench_state.context[index][0]);
+      fprintf(ubench_state.json, ": ");
+      ubench_json_string(ubench_state.json, ubench_state.context[index][1]);
+    }
+    fprintf(ubench_state.json, "\n  },\n  \"benchmarks\": [");
   }
 
   for (index = 0; index < ubench_state.benchmarks_length; index++) {
@@ -606,6 +1228,9 @@ int ubench_main(int argc, const char *const argv[]) {
     ubench_int64_t best_avg_ns = 0;
     double best_deviation = 0;
     double best_confidence = 101.0;
+    /* counters per iteration of the best run, negative if not available */
+    double best_perf[UBENCH_PERF_COUNTER_COUNT];
+    size_t counter = 0;
     struct ubench_run_state_s ubs;
 
 #define UBENCH_MIN_ITERATIONS 10
@@ -625,9 +1250,17 @@ int ubench_main(int argc, const char *const argv[]) {
     printf("%s[ RUN      ]%s %s\n", colours[GREEN], colours[RESET],
            ubench_state.benchmarks[index].name);
 
+    for (counter = 0; counter < UBENCH_PERF_COUNTER_COUNT; counter++) {
+      best_perf[counter] = -1.0;
+    }
+
     ubs.ns     = ns;
     ubs.size   = 1;
     ubs.sample = 0;
+    ubs.bytes  = 0;
+    ubs.warmup = ubench_state.cache_mode == UBENCH_CACHE_HOT;
+    ubs.cache_ranges_length = 0;
+    ubench_state.run = &ubs;
 
     /* Time once to work out the base number of iterations to use. */
     ubench_state.benchmarks[index].func(&ubs);
@@ -647,6 +1280,8 @@ int ubench_main(int argc, const char *const argv[]) {
 
       ubs.sample = 0;
       ubs.size   = iterations;
+      ubs.warmup = ubench_state.cache_mode == UBENCH_CACHE_HOT;
+      ubs.cache_ranges_length = 0;
       ubench_state.benchmarks[index].func(&ubs);
 
       /* Calculate benchmark run-times */
@@ -681,6 +1316,10 @@ int ubench_main(int argc, const char *const argv[]) {
         best_avg_ns = avg_ns;
         best_deviation = deviation;
         best_confidence = confidence;
+        for (counter = 0; counter < UBENCH_PERF_COUNTER_COUNT; counter++) {
+          best_perf[counter] = UBENCH_CAST(double, ubs.perf[counter]) /
+                               UBENCH_CAST(double, iterations);
+        }
       }
     }
 
@@ -690,9 +1329,51 @@ int ubench_main(int argc, const char *const argv[]) {
     }
 
     if (ubench_state.output) {
-      fprintf(ubench_state.output, "%s, %" UBENCH_PRId64 ", %f, %f,\n",
+      fprintf(ubench_state.output,
+              "%s, %" UBENCH_PRId64 ", %f, %f, %" UBENCH_PRId64 ", %f,",
               ubench_state.benchmarks[index].name, best_avg_ns, best_deviation,
-              best_confidence);
+              best_confidence, ubs.bytes,
+              best_avg_ns > 0 ? UBENCH_CAST(double, ubs.bytes) /
+                                    UBENCH_CAST(double, best_avg_ns)
+                              : 0.0);
+      for (counter = 0; ubench_state.perf && counter < UBENCH_PERF_COUNTER_COUNT;
+           counter++) {
+        if (best_perf[counter] >= 0) {
+          fprintf(ubench_state.output, " %.1f,", best_perf[counter]);
+        } else {
+          fprintf(ubench_state.output, " ,");
+        }
+      }
+      fprintf(ubench_state.output, "\n");
+    }
+
+    if (ubench_state.json) {
+      fprintf(ubench_state.json, "%s\n    {\"name\": ",
+              json_benchmarks++ ? "," : "");
+      ubench_json_string(ubench_state.json,
+                         ubench_state.benchmarks[index].name);
+      fprintf(ubench_state.json,
+              ", \"mean_ns\": %" UBENCH_PRId64 ", \"stddev_pct\": %f, "
+              "\"confidence_pct\": %f, \"bytes\": %" UBENCH_PRId64
+              ", \"gb_per_s\": %f, \"passed\": %s",
+              best_avg_ns, best_deviation, best_confidence, ubs.bytes,
+              best_avg_ns > 0 ? UBENCH_CAST(double, ubs.bytes) /
+                                    UBENCH_CAST(double, best_avg_ns)
+                              : 0.0,
+              result ? "false" : "true");
+      if (ubench_state.perf) {
+        const char *separator = "";
+        fprintf(ubench_state.json, ", \"counters\": {");
+        for (counter = 0; counter < UBENCH_PERF_COUNTER_COUNT; counter++) {
+          if (best_perf[counter] >= 0) {
+            fprintf(ubench_state.json, "%s\"%s\": %.1f", separator,
+                    ubench_perf_counter_names[counter], best_perf[counter]);
+            separator = ", ";
+          }
+        }
+        fprintf(ubench_state.json, "}");
+      }
+      fprintf(ubench_state.json, "}");
     }
 
     {
@@ -700,6 +1381,10 @@ int ubench_main(int argc, const char *const argv[]) {
       const char *const status =
           (0 != result) ? "[  FAILED  ]" : "[       OK ]";
       const char *unit = "us";
+      const double gb_per_s =
+          best_avg_ns > 0 ? UBENCH_CAST(double, ubs.bytes) /
+                                UBENCH_CAST(double, best_avg_ns)
+                          : 0.0;
 
       if (0 != result) {
         const size_t failed_benchmark_index = failed_benchmarks_length++;
@@ -733,8 +1418,34 @@ int ubench_main(int argc, const char *const argv[]) {
       }
 
       printf("%" UBENCH_PRId64 ".%03" UBENCH_PRId64
-             "%s, confidence interval +- %f%%)\n",
+             "%s, confidence interval +- %f%%",
              best_avg_ns / 1000, best_avg_ns % 1000, unit, best_confidence);
+
+      if (ubs.bytes > 0) {
+        printf(", %" UBENCH_PRId64 " bytes, %.2f GB/s", ubs.bytes, gb_per_s);
+      }
+      printf(")\n");
+    }
+
+    if (ubench_state.perf) {
+      const char *separator = "";
+      printf("%s[   PERF   ]%s %s (per iteration: ", colours[GREEN],
+             colours[RESET], ubench_state.benchmarks[index].name);
+      for (counter = 0; counter < UBENCH_PERF_COUNTER_COUNT; counter++) {
+        if (best_perf[counter] < 0) {
+          continue;
+        }
+        printf("%s%.0f %s", separator, best_perf[counter],
+               ubench_perf_counter_names[counter]);
+        separator = ", ";
+        if (counter == UBENCH_PERF_INSTRUCTIONS &&
+            best_perf[UBENCH_PERF_CYCLES] > 0) {
+          printf(", %.2f IPC",
+                 best_perf[UBENCH_PERF_INSTRUCTIONS] /
+                     best_perf[UBENCH_PERF_CYCLES]);
+        }
+      }
+      printf(")\n");
     }
   }
 
@@ -752,7 +1463,15 @@ int ubench_main(int argc, const char *const argv[]) {
     }
   }
 
+  if (ubench_state.json) {
+    fprintf(ubench_state.json, "\n  ]\n}\n");
+  }
+
 cleanup:
+  ubench_perf_close();
+  ubench_cache_close();
+  ubench_state.run = UBENCH_NULL;
+
   for (index = 0; index < ubench_state.benchmarks_length; index++) {
     free(UBENCH_PTR_CAST(void *, ubench_state.benchmarks[index].name));
   }
@@ -764,6 +1483,10 @@ cleanup:
     fclose(ubench_state.output);
   }
 
+  if (ubench_state.json) {
+    fclose(ubench_state.json);
+  }
+
   return UBENCH_CAST(int, failed);
 }
 
@@ -805,7 +1528,8 @@ UBENCH_C_FUNC void _ReadWriteBarrier(void);
 */
 #define UBENCH_STATE()                                                         \
   UBENCH_DECLARE_DO_NOTHING()                                                  \
-  struct ubench_state_s ubench_state = {0, 0, 0, 2.5}
+  struct ubench_state_s ubench_state = {                                       \
+      0, 0, 0, 2.5, 0, {0}, 0, {{0}}, 0, 0, 0, 0, 0}
 
 /*
    define a main() function to call into ubench.h and start executing
@@ -32,9 +32,9 @@
 
 #include <string.h>
 #include <stdint.h>
+#include <stddef.h>
 
 // TODO:
-// * missing memcpy_rectrot_180() that does a full rotate (better name needed!)
 // * need versions taking item-size of all functions, maybe add item size on all ops
 //   and specialize them as _1, _2, _4, _8 and _16?
 // * go through doc!
@@ -48,6 +48,78 @@
  */
 inline void memswap( void* ptr1, void* ptr2, size_t bytes );
 
+/**
+ * kernels that memswap() can be dispatched to.
+ */
+enum memswap_kernel
+{
+	MEMSWAP_KERNEL_GENERIC,
+	MEMSWAP_KERNEL_MEMCPY,
+	MEMSWAP_KERNEL_SSE2,
+	MEMSWAP_KERNEL_SSE2_UNROLL,
+	MEMSWAP_KERNEL_AVX,
+	MEMSWAP_KERNEL_AVX_UNROLL,
+	MEMSWAP_KERNEL_AVX512,
+	MEMSWAP_KERNEL_AVX512_UNROLL,
+	MEMSWAP_KERNEL_SSE2_STREAM,
+	MEMSWAP_KERNEL_AVX_STREAM,
+
+	MEMSWAP_KERNEL_COUNT
+};
+
+/**
+ * set the size, in bytes, from where memswap() switches over to a kernel using non-temporal stores and
+ * software prefetch. Swapping big buffers with regular stores will evict the entire cache for both buffers.
+ *
+ * @note defaults to MEMCPY_UTIL_MEMSWAP_STREAM_THRESHOLD, SIZE_MAX unless set by memcpy_util_tuning.h, i.e.
+ *       streaming is disabled. A swap reads every cache line it writes so streaming saves no read-for-ownership
+ *       and only pays off on machines where keeping the cache intact is worth more than the lost bandwidth.
+ *       Pass SIZE_MAX to disable streaming.
+ *
+ * @param bytes swaps of this many bytes or more will use streaming stores.
+ */
+inline void memswap_set_stream_threshold( size_t bytes );
+
+/**
+ * return the size, in bytes, from where memswap() use streaming stores.
+ */
+inline size_t memswap_get_stream_threshold();
+
+/**
+ * return the kernel that memswap() currently dispatches to.
+ *
+ * @note the best kernel for the current cpu is selected once on first use of memswap() or any of the
+ *       memswap_kernel-functions.
+ */
+inline memswap_kernel memswap_get_kernel();
+
+/**
+ * force memswap() to dispatch to a specific kernel, mostly useful for benchmarks and tests.
+ *
+ * @note the pinned kernel is used for all sizes, i.e. it also replaces the streaming kernel used above the stream
+ *       threshold. Setting the kernel returned by memswap_best_kernel() restores the default dispatch.
+ *
+ * @param kernel kernel to use.
+ *
+ * @return false if kernel is not supported by the current cpu, in that case the active kernel is left unchanged.
+ */
+inline bool memswap_set_kernel( memswap_kernel kernel );
+
+/**
+ * return the kernel that would be selected as default for the current cpu.
+ */
+inline memswap_kernel memswap_best_kernel();
+
+/**
+ * return true if kernel can be used on the current cpu.
+ */
+inline bool memswap_kernel_supported( memswap_kernel kernel );
+
+/**
+ * return the name of a kernel, i.e. "avx_unroll".
+ */
+inline const char* memswap_kernel_name( memswap_kernel kernel );
+
 /**
  * copy rect.
  *
@@ -75,10 +147,53 @@ inline void memswap( void* ptr1, void* ptr2, size_t bytes );
  */
 inline void* memcpy_rect( void* dst, void* src, size_t lines, size_t linelen, size_t dststride, size_t srcstride );
 
+/**
+ * function used by the _parallel-functions to run work on multiple threads, usually implemented on top of
+ * the job-system or thread-pool of the user.
+ *
+ * should call job(job_data, job_index) once for every job_index in [0, job_count) and not return until all
+ * jobs are done.
+ */
+typedef void (*memcpy_util_parallel_for_t)( void (*job)( void* job_data, size_t job_index ), void* job_data, size_t job_count, void* userdata );
+
+/**
+ * config for how the _parallel-functions split their work.
+ */
+struct memcpy_util_parallel
+{
+	memcpy_util_parallel_for_t parallel_for; ///< function used to run the jobs.
+	void*  userdata;                         ///< passed to parallel_for.
+	size_t job_count;                        ///< max number of jobs to split work into, usually the number of threads.
+	size_t min_bytes;                        ///< calls processing less bytes than this are run single threaded,
+	                                         ///< MEMCPY_UTIL_PARALLEL_MIN_BYTES is a sensible default.
+};
+
+/**
+ * swap memory in two buffers, splitting the work into cache-line aligned chunks run via par->parallel_for.
+ *
+ * @note falls back to memswap() if par is null or bytes is smaller than par->min_bytes.
+ *
+ * @param ptr1 pointer to first buffer.
+ * @param ptr2 pointer to second buffer.
+ * @param bytes number of bytes to swap.
+ * @param par how to split and run the work.
+ */
+inline void memswap_parallel( void* ptr1, void* ptr2, size_t bytes, const memcpy_util_parallel* par );
+
+/**
+ * copy rect, splitting the lines into jobs run via par->parallel_for.
+ *
+ * @note falls back to memcpy_rect() if par is null or lines * linelen is smaller than par->min_bytes.
+ *
+ * @see memcpy_rect for parameters.
+ */
+inline void* memcpy_rect_parallel( void* dst, void* src, size_t lines, size_t linelen, size_t dststride, size_t srcstride, const memcpy_util_parallel* par );
+
 /**
  * copy rect.
  *
- * @note this is the same operation as memcpy_rect except this is safe where dst and src overlap.
+ * @note this is the same operation as memcpy_rect except this is safe where dst and src overlap, also when dst and
+ *       src have different strides as long as linelen is not bigger than either of them.
  *
  * @param dst destination buffer where to start the copy
  * @param src source buffer to copy from.
@@ -128,10 +243,31 @@ inline void* memmove_rect( void* dst, void* src, size_t lines, size_t linelen, s
 inline void* memcpy_rectrotr ( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
 inline void* memmove_rectrotr( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
 
-// TODO: better name
-// TODO: better doc, but this is the same as _rectrotr but with copied chunks being more than one byte, i.e. pixels in an image ;)
-//       maybe the original rectrotr-functions that are just on bytes are quite useless as this kind of operation is usually done on
-//       items with a size over 1 (read pixels)
+/**
+ * copy rect rotated right 90 deg, same as memcpy_rectrotr but on items of item_size bytes, i.e. pixels in an image.
+ *
+ * @note 1, 2, 4 and 8 byte items are rotated with simd-transposes and 3, 12 and 16 byte items have their own
+ *       copy-loops, all other sizes work but are slower.
+ *
+ * @param linelen number of 'items' in lines to copy from src.
+ * @param dststride number of 'items' between each row in dst.
+ * @param srcstride number of 'items' between each row in src.
+ * @param item_size size of 'atom' in a line in bytes.
+ */
+inline void* memcpy_rectrotr_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size );
+
+/**
+ * same as memcpy_rectrotr_x but dst and src may overlap, i.e. rotating an image in place.
+ *
+ * @note a square rect rotated in place is rotated tile by tile and an image rotated in its own buffer, dst == src,
+ *       srcstride == linelen and dststride == linecnt, is rotated in bands, both via a 4kb stack-buffer, for bands
+ *       only if a line or column fit in it. All other overlapping rects are rotated by following where each item is
+ *       moved one item at a time. That works with any rect-size and stride but is slow for large rects, use
+ *       memmove_rectrotr_scratch() if there is memory to spare.
+ * @note dst and src need to be a multiple of item_size apart if they overlap.
+ *
+ * @return dst or 0 if dst and src overlap with an offset that is not a multiple of item_size, nothing is moved then.
+ */
 inline void* memmove_rectrotr_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size );
 
 /**
@@ -160,10 +296,49 @@ inline void* memmove_rectrotr_x( void* dst, void* src, size_t linecnt, size_t li
 inline void* memcpy_rectrotl( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
 inline void* memmove_rectrotl( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
 
-// TODO: better name
-// TODO: add unittest when src and dst overlap but is one byte of.
+/**
+ * copy rect rotated left 90 deg, same as memcpy_rectrotl but on items of item_size bytes, i.e. pixels in an image.
+ *
+ * @note 1, 2, 4 and 8 byte items are rotated with simd-transposes and 3, 12 and 16 byte items have their own
+ *       copy-loops, all other sizes work but are slower.
+ *
+ * @param linelen number of 'items' in lines to copy from src.
+ * @param dststride number of 'items' between each row in dst.
+ * @param srcstride number of 'items' between each row in src.
+ * @param item_size size of 'atom' in a line in bytes.
+ */
+inline void* memcpy_rectrotl_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size );
+
+/**
+ * same as memcpy_rectrotl_x but dst and src may overlap, see memmove_rectrotr_x.
+ */
 inline void* memmove_rectrotl_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size );
 
+/**
+ * same as memmove_rectrotr_x/memmove_rectrotl_x but with a caller supplied scratch-buffer that is used to speed up
+ * the rotation when dst and src overlap, no other memory is allocated.
+ *
+ * if scratch_size >= linecnt * linelen * item_size src is copied to scratch and rotated from there. Otherwise an
+ * image rotated in its own buffer, dst == src, srcstride == linelen and dststride == linecnt, is rotated in 3 passes
+ * that move bands of up to 256 bytes wide columns or one line at a time through scratch if it fits
+ * max( linecnt, linelen ) * item_size bytes, the more columns of linecnt items that fit the faster. A square
+ * rotated in place use scratch for its tiles if it is larger than the 4kb the tiles are rotated via otherwise.
+ * For other overlapping rects scratch is used to keep track of moved items if it is >= ( linecnt * linelen + 7 ) / 8,
+ * otherwise it is not used.
+ *
+ * @note without a big enough scratch, rotating in place follows each item from where it is to where it is moved which
+ *       is very slow for large rects, i.e. a 1920x1080 rgba8 image takes ~550ms rotated in place without scratch,
+ *       ~12ms with 64 columns of scratch, ~3ms with scratch that fit all of it and ~1.5ms rotated to another buffer.
+ *
+ * @param scratch buffer that may be overwritten during the call, can be 0.
+ * @param scratch_size size of scratch in bytes.
+ *
+ * @return dst or 0 if dst and src overlap with an offset that is not a multiple of item_size and scratch is too small
+ *         to fit all of src.
+ */
+inline void* memmove_rectrotr_scratch( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size, void* scratch, size_t scratch_size );
+inline void* memmove_rectrotl_scratch( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size, void* scratch, size_t scratch_size );
+
 /**
  * copy rect flipped horizontally.
  *
@@ -276,6 +451,121 @@ inline void* memcpy_rectflipv( void* dst, void* src, size_t linecnt, size_t line
  */
 inline void* memmove_rectflipv( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size );
 
+/**
+ * copy rect rotated 180 deg, i.e. flipped both horizontally and vertically in one pass.
+ *
+ * @note if dst and src overlap, this is undefined and will most likely not do what was expected.
+ *
+ * @param dst destination buffer where to start the copy
+ * @param src source buffer to copy from.
+ * @param lines number of lines to copy from src.
+ * @param linelen number of 'items' in lines to copy from src.
+ * @param dststride number of 'items' between each row in dst.
+ * @param srcstride number of 'items' between each row in src.
+ * @param item_size size of 'atom' in a line in bytes.
+ *
+ * src:             dst:
+ * X---+-------+    +-----------+
+ * |123|       | -> |           |
+ * |456|       |    | Y---+     |
+ * +---+       |    | |654|     |
+ * |           |    | |321|     |
+ * |           |    | +---+     |
+ * +-----------+    +-----------+
+ * <-srcstride->    <-dststride->
+ *
+ * X = src passed to function
+ * Y = dst passed to function
+ */
+inline void* memcpy_rectrot180( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size );
+
+/**
+ * move rect rotated 180 deg.
+ *
+ * @note this is the same operation as memcpy_rectrot180 except this is safe where dst and src overlap.
+ *
+ * @param dst destination buffer where to start the copy
+ * @param src source buffer to copy from.
+ * @param lines number of lines to copy from src.
+ * @param linelen number of 'items' in lines to copy from src.
+ * @param dststride number of 'items' between each row in dst.
+ * @param srcstride number of 'items' between each row in src.
+ * @param item_size size of 'atom' in a line in bytes.
+ *
+ * src:             dst:
+ * X---+-------+    +-----------+
+ * |123|       | -> |           |
+ * |456|       |    | Y---+     |
+ * +---+       |    | |654|     |
+ * |           |    | |321|     |
+ * |           |    | +---+     |
+ * +-----------+    +-----------+
+ * <-srcstride->    <-dststride->
+ *
+ * X = src passed to function
+ * Y = dst passed to function
+ */
+inline void* memmove_rectrot180( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size );
+
+/**
+ * orientations for memcpy_rectorient, the 8 ways a rect can be rotated and/or mirrored. All orientations can be
+ * reached by combining the other functions in this header, but memcpy_rectorient do it in one pass over memory.
+ */
+enum memcpy_rect_orientation
+{
+	MEMCPY_RECT_ORIENT_IDENTITY,   ///< plain copy, same as memcpy_rect.
+	MEMCPY_RECT_ORIENT_ROTR,       ///< rotate right 90 deg, same as memcpy_rectrotr.
+	MEMCPY_RECT_ORIENT_ROT180,     ///< rotate 180 deg, same as memcpy_rectrot180.
+	MEMCPY_RECT_ORIENT_ROTL,       ///< rotate left 90 deg, same as memcpy_rectrotl.
+	MEMCPY_RECT_ORIENT_FLIPH,      ///< flip horizontally, same as memcpy_rectfliph.
+	MEMCPY_RECT_ORIENT_FLIPV,      ///< flip vertically, same as memcpy_rectflipv.
+	MEMCPY_RECT_ORIENT_TRANSPOSE,  ///< swap lines and items, same as memcpy_rectrotr followed by memcpy_rectflipv.
+	MEMCPY_RECT_ORIENT_TRANSVERSE, ///< transpose and rotate 180 deg, same as memcpy_rectrotr followed by memcpy_rectfliph.
+
+	MEMCPY_RECT_ORIENT_COUNT
+};
+
+/**
+ * copy rect in any of the orientations in memcpy_rect_orientation. This replace a chain of for example crop, rotate
+ * and flip with one pass over the memory where the orientations that swap lines and items are done in cache-sized
+ * tiles the same way as memcpy_rectrotr. To work on a sub-rect of a bigger image, pass a pointer to the top-left item
+ * of the sub-rect as src and the stride of the image.
+ *
+ * @note if dst and src overlap, this is undefined and will most likely not do what was expected.
+ *
+ * @param dst destination buffer where to start the copy
+ * @param src source buffer to copy from.
+ * @param lines number of lines to copy from src.
+ * @param linelen number of 'items' in lines to copy from src.
+ * @param dststride number of 'items' between each row in dst.
+ * @param srcstride number of 'items' between each row in src.
+ * @param item_size size of 'atom' in a line in bytes.
+ * @param orientation orientation of the rect written to dst, dst will be linelen lines of linecnt items for
+ *                    the orientations that swap lines and items, otherwise linecnt lines of linelen items.
+ */
+inline void* memcpy_rectorient( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size, memcpy_rect_orientation orientation );
+
+/**
+ * compile time item-size versions of memcpy_rectrotr_x, memmove_rectrotr_x, memcpy_rectrotl_x, memmove_rectrotl_x,
+ * memcpy_rectflipv, memmove_rectflipv, memcpy_rectrot180, memmove_rectrot180 and memcpy_rectorient. Same as calling
+ * the runtime version with item_size = ITEM_SIZE but all per-item copies are done with a constant size.
+ *
+ * The runtime versions already dispatch to these for item-sizes 1, 2, 3, 4, 6, 8, 12, 16 and 24, calling them directly
+ * is useful when the item-size is known to be something else or to skip the dispatch.
+ *
+ * example:
+ * memcpy_rectflipv<4>( dst, src, linecnt, linelen, dststride, srcstride );
+ */
+template <size_t ITEM_SIZE> inline void* memcpy_rectrotr_x ( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
+template <size_t ITEM_SIZE> inline void* memmove_rectrotr_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
+template <size_t ITEM_SIZE> inline void* memcpy_rectrotl_x ( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
+template <size_t ITEM_SIZE> inline void* memmove_rectrotl_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
+template <size_t ITEM_SIZE> inline void* memcpy_rectflipv  ( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
+template <size_t ITEM_SIZE> inline void* memmove_rectflipv ( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
+template <size_t ITEM_SIZE> inline void* memcpy_rectrot180 ( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
+template <size_t ITEM_SIZE> inline void* memmove_rectrot180( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride );
+template <size_t ITEM_SIZE> inline void* memcpy_rectorient ( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, memcpy_rect_orientation orientation );
+
 
 
 ///////////////////////////////////////////////////////
@@ -285,9 +575,64 @@ inline void* memmove_rectflipv( void* dst, void* src, size_t linecnt, size_t lin
 #include <immintrin.h>
 
 #if defined(__GNUC__) || defined(__clang__)
-#   define MEMCPY_UTIL_TARGET_AVX __attribute__((target("avx")))
+#   define MEMCPY_UTIL_TARGET_SSSE3  __attribute__((target("ssse3")))
+#   define MEMCPY_UTIL_TARGET_AVX    __attribute__((target("avx")))
+#   define MEMCPY_UTIL_TARGET_AVX2   __attribute__((target("avx2")))
+#   define MEMCPY_UTIL_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
 #else
+#   define MEMCPY_UTIL_TARGET_SSSE3
 #   define MEMCPY_UTIL_TARGET_AVX
+#   define MEMCPY_UTIL_TARGET_AVX2
+#   define MEMCPY_UTIL_TARGET_AVX512
+#endif
+
+// machine-tuned values for the defines below, generated by running the memcpy_util_tune target, see
+// tune/memcpy_util_tune.cpp. Picked up when found next to memcpy_util.h or in the include-path, values defined
+// before including memcpy_util.h still win. Define MEMCPY_UTIL_NO_TUNING_HEADER to ignore it.
+#if !defined(MEMCPY_UTIL_NO_TUNING_HEADER) && defined(__has_include)
+#	if __has_include("memcpy_util_tuning.h")
+#		include "memcpy_util_tuning.h"
+#	endif
+#endif
+
+#if !defined(MEMCPY_UTIL_MEMSWAP_STREAM_THRESHOLD)
+	// default size where memswap() switch to streaming stores, see memswap_set_stream_threshold(). Disabled by
+	// default as the streaming kernels are slower than the regular ones on all sizes measured so far, run
+	// memcpy_util_tune to find out if they win on your machine.
+#	define MEMCPY_UTIL_MEMSWAP_STREAM_THRESHOLD SIZE_MAX
+#endif
+
+#if !defined(MEMCPY_UTIL_ROTATE_TILE_SIZE)
+	// width and height, in items, of the tiles used by the rotation-functions. Should be picked so that one tile
+	// of src and dst fits in L1.
+#	define MEMCPY_UTIL_ROTATE_TILE_SIZE 64
+#endif
+
+#if !defined(MEMCPY_UTIL_PARALLEL_MIN_BYTES)
+	// suggested value for memcpy_util_parallel::min_bytes, below this the cost of starting jobs dominates.
+#	define MEMCPY_UTIL_PARALLEL_MIN_BYTES (8 * 1024 * 1024)
+#endif
+
+#if !defined(MEMCPY_UTIL_STREAM_PREFETCH_DISTANCE)
+	// how many bytes ahead of the current position the streaming kernels prefetch.
+#	define MEMCPY_UTIL_STREAM_PREFETCH_DISTANCE 512
+#endif
+
+#if !defined(MEMCPY_UTIL_MEMSWAP_CHUNK_SIZE)
+	// size of the stack-buffer memswap_memcpy() and memswap_memcpy_ptr() swap through.
+#	define MEMCPY_UTIL_MEMSWAP_CHUNK_SIZE 256
+#endif
+
+#if !defined(MEMCPY_UTIL_MEMSWAP_UNROLL)
+	// number of vectors swapped per iteration by the _unroll memswap-kernels.
+#	define MEMCPY_UTIL_MEMSWAP_UNROLL 4
+#endif
+
+#if defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 8)
+	// loops over MEMCPY_UTIL_MEMSWAP_UNROLL need to be fully unrolled for tmp-arrays to stay in registers.
+#	define MEMCPY_UTIL_UNROLL_LOOP _Pragma("GCC unroll 16")
+#else
+#	define MEMCPY_UTIL_UNROLL_LOOP
 #endif
 ;
 inline void memswap_generic( void* ptr1, void* ptr2, size_t bytes )
@@ -307,7 +652,7 @@ inline void memswap_memcpy( void* ptr1, void* ptr2, size_t bytes )
 	uint8_t* s1 = (uint8_t*)ptr1;
 	uint8_t* s2 = (uint8_t*)ptr2;
 
-	char tmp[256];
+	char tmp[MEMCPY_UTIL_MEMSWAP_CHUNK_SIZE];
 	size_t chunks = bytes / sizeof(tmp);
 	for(size_t i = 0; i < chunks; ++i)
 	{
@@ -329,7 +674,7 @@ inline void memswap_memcpy_ptr( void* ptr1, void* ptr2, size_t bytes )
 	uint8_t* s1 = (uint8_t*)ptr1;
 	uint8_t* s2 = (uint8_t*)ptr2;
 
-	char tmp[256];
+	char tmp[MEMCPY_UTIL_MEMSWAP_CHUNK_SIZE];
 	size_t chunks = bytes / sizeof(tmp);
 	for(size_t i = 0; i < chunks; ++i)
 	{
@@ -344,118 +689,290 @@ inline void memswap_memcpy_ptr( void* ptr1, void* ptr2, size_t bytes )
 	memcpy_ptr(s2 + chunks * sizeof(tmp), tmp,                       bytes % sizeof(tmp) );
 }
 
-inline void memswap_sse2( void* ptr1, void* ptr2, size_t bytes )
+// number of bytes to advance ptr to get it aligned to alignment, clamped to max_bytes.
+inline size_t memcpy_util_bytes_to_align( const void* ptr, size_t alignment, size_t max_bytes )
 {
-	size_t chunks = bytes / sizeof(__m128);
+	size_t bytes = (alignment - ((uintptr_t)ptr & (alignment - 1))) & (alignment - 1);
+	return bytes > max_bytes ? max_bytes : bytes;
+}
 
-	// swap as much as possible with the sse-registers ...
-	for(size_t i = 0; i < chunks; ++i)
-	{
-		float* src1 = (float*)ptr1 + i * (sizeof(__m128) / sizeof(float));
-		float* src2 = (float*)ptr2 + i * (sizeof(__m128) / sizeof(float));
+// the simd-swaps peel of bytes at the start until ptr1 is aligned to the vector-width so that the main-loop never
+// splits a cache-line on ptr1. If ptr1 and ptr2 had the same misalignment both streams end up aligned.
+// Peeling is only worth it if there is a few vectors to swap after the peel.
+#define MEMSWAP_ALIGN_PROLOGUE(VEC_SIZE)                                        \
+	uint8_t* s1 = (uint8_t*)ptr1;                                               \
+	uint8_t* s2 = (uint8_t*)ptr2;                                               \
+	if( bytes >= VEC_SIZE * 4 )                                                 \
+	{                                                                           \
+		size_t head = memcpy_util_bytes_to_align( s1, VEC_SIZE, bytes );        \
+		memswap_generic(s1, s2, head);                                          \
+		s1    += head;                                                          \
+		s2    += head;                                                          \
+		bytes -= head;                                                          \
+	}                                                                           \
+	const bool s1_aligned = ((uintptr_t)s1 & (VEC_SIZE - 1)) == 0;              \
+	const bool s2_aligned = ((uintptr_t)s2 & (VEC_SIZE - 1)) == 0;
+
+#define MEMSWAP_SWAP_LOOP(VEC_TYPE, LOAD1, STORE1, LOAD2, STORE2)              \
+	for(size_t i = 0; i < chunks; ++i)                                          \
+	{                                                                           \
+		float* src1 = (float*)(s1 + i * sizeof(VEC_TYPE));                      \
+		float* src2 = (float*)(s2 + i * sizeof(VEC_TYPE));                      \
+		VEC_TYPE tmp = LOAD1(src1);                                             \
+		STORE1(src1, LOAD2(src2));                                              \
+		STORE2(src2, tmp);                                                      \
+	}
 
-		__m128 tmp =_mm_loadu_ps(src1);
-		_mm_storeu_ps(src1, _mm_loadu_ps(src2));
-		_mm_storeu_ps(src2, tmp);
+#define MEMSWAP_SWAP_LOOP_UNROLL(VEC_TYPE, LOAD1, STORE1, LOAD2, STORE2)       \
+	for(size_t i = 0; i < chunks; ++i)                                          \
+	{                                                                           \
+		const size_t FLOATS = sizeof(VEC_TYPE) / sizeof(float);                 \
+		float* src1 = (float*)(s1 + i * MEMCPY_UTIL_MEMSWAP_UNROLL * sizeof(VEC_TYPE)); \
+		float* src2 = (float*)(s2 + i * MEMCPY_UTIL_MEMSWAP_UNROLL * sizeof(VEC_TYPE)); \
+		VEC_TYPE tmp[MEMCPY_UTIL_MEMSWAP_UNROLL];                               \
+		MEMCPY_UTIL_UNROLL_LOOP                                                 \
+		for(size_t u = 0; u < MEMCPY_UTIL_MEMSWAP_UNROLL; ++u)                  \
+			tmp[u] = LOAD1(src1 + u * FLOATS);                                  \
+		MEMCPY_UTIL_UNROLL_LOOP                                                 \
+		for(size_t u = 0; u < MEMCPY_UTIL_MEMSWAP_UNROLL; ++u)                  \
+			STORE1(src1 + u * FLOATS, LOAD2(src2 + u * FLOATS));                \
+		MEMCPY_UTIL_UNROLL_LOOP                                                 \
+		for(size_t u = 0; u < MEMCPY_UTIL_MEMSWAP_UNROLL; ++u)                  \
+			STORE2(src2 + u * FLOATS, tmp[u]);                                  \
 	}
 
+#define MEMSWAP_SWAP_ALIGNED(LOOP, VEC_TYPE, LOAD, STORE, LOADU, STOREU)       \
+	if( s1_aligned && s2_aligned )                                              \
+		LOOP(VEC_TYPE, LOAD, STORE, LOAD, STORE)                                \
+	else if( s1_aligned )                                                       \
+		LOOP(VEC_TYPE, LOAD, STORE, LOADU, STOREU)                              \
+	else                                                                        \
+		LOOP(VEC_TYPE, LOADU, STOREU, LOADU, STOREU)
+
+inline void memswap_sse2( void* ptr1, void* ptr2, size_t bytes )
+{
+	MEMSWAP_ALIGN_PROLOGUE(sizeof(__m128))
+
+	// swap as much as possible with the sse-registers ...
+	size_t chunks = bytes / sizeof(__m128);
+	MEMSWAP_SWAP_ALIGNED(MEMSWAP_SWAP_LOOP, __m128, _mm_load_ps, _mm_store_ps, _mm_loadu_ps, _mm_storeu_ps)
+
 	// ... and swap the remaining bytes with the generic swap ...
-	uint8_t* s1 = (uint8_t*)ptr1 + chunks * sizeof(__m128);
-	uint8_t* s2 = (uint8_t*)ptr2 + chunks * sizeof(__m128);
-	memswap_generic(s1, s2, bytes % sizeof(__m128));
+	memswap_generic(s1 + chunks * sizeof(__m128), s2 + chunks * sizeof(__m128), bytes % sizeof(__m128));
 }
 
 MEMCPY_UTIL_TARGET_AVX
 inline void memswap_avx( void* ptr1, void* ptr2, size_t bytes )
 {
-	size_t chunks = bytes / sizeof(__m256);
+	MEMSWAP_ALIGN_PROLOGUE(sizeof(__m256))
 
 	// swap as much as possible with the avx-registers ...
+	size_t chunks = bytes / sizeof(__m256);
+	MEMSWAP_SWAP_ALIGNED(MEMSWAP_SWAP_LOOP, __m256, _mm256_load_ps, _mm256_store_ps, _mm256_loadu_ps, _mm256_storeu_ps)
+
+	// ... and swap the remaining bytes with the generic swap ...
+	memswap_generic(s1 + chunks * sizeof(__m256), s2 + chunks * sizeof(__m256), bytes % sizeof(__m256));
+}
+
+inline void memswap_sse2_unroll( void* ptr1, void* ptr2, size_t bytes )
+{
+	MEMSWAP_ALIGN_PROLOGUE(sizeof(__m128))
+
+	size_t chunks = bytes / (sizeof(__m128) * MEMCPY_UTIL_MEMSWAP_UNROLL);
+	MEMSWAP_SWAP_ALIGNED(MEMSWAP_SWAP_LOOP_UNROLL, __m128, _mm_load_ps, _mm_store_ps, _mm_loadu_ps, _mm_storeu_ps)
+
+	// ... and swap the remaining bytes with the non-unrolled swap ...
+	size_t bytes_processed = (chunks * MEMCPY_UTIL_MEMSWAP_UNROLL) * sizeof(__m128);
+	memswap_sse2(s1 + bytes_processed,
+				 s2 + bytes_processed,
+				 bytes - bytes_processed);
+}
+
+MEMCPY_UTIL_TARGET_AVX
+inline void memswap_avx_unroll( void* ptr1, void* ptr2, size_t bytes )
+{
+	MEMSWAP_ALIGN_PROLOGUE(sizeof(__m256))
+
+	size_t chunks = bytes / (sizeof(__m256) * MEMCPY_UTIL_MEMSWAP_UNROLL);
+	MEMSWAP_SWAP_ALIGNED(MEMSWAP_SWAP_LOOP_UNROLL, __m256, _mm256_load_ps, _mm256_store_ps, _mm256_loadu_ps, _mm256_storeu_ps)
+
+	// ... and swap the remaining bytes with the non-unrolled swap ...
+	size_t bytes_processed = (chunks * MEMCPY_UTIL_MEMSWAP_UNROLL) * sizeof(__m256);
+	memswap_avx(s1 + bytes_processed,
+				s2 + bytes_processed,
+				bytes - bytes_processed);
+}
+
+#undef MEMSWAP_ALIGN_PROLOGUE
+#undef MEMSWAP_SWAP_LOOP
+#undef MEMSWAP_SWAP_LOOP_UNROLL
+#undef MEMSWAP_SWAP_ALIGNED
+
+MEMCPY_UTIL_TARGET_AVX512
+inline void memswap_avx512( void* ptr1, void* ptr2, size_t bytes )
+{
+	size_t chunks = bytes / sizeof(__m512i);
+
+	// swap as much as possible with the avx512-registers ...
 	for(size_t i = 0; i < chunks; ++i)
 	{
-		float* src1 = (float*)ptr1 + i * (sizeof(__m256) / sizeof(float));
-		float* src2 = (float*)ptr2 + i * (sizeof(__m256) / sizeof(float));
-		__m256 tmp  = _mm256_loadu_ps(src1);
-		_mm256_storeu_ps(src1, _mm256_loadu_ps(src2));
-		_mm256_storeu_ps(src2, tmp);
+		uint8_t* src1 = (uint8_t*)ptr1 + i * sizeof(__m512i);
+		uint8_t* src2 = (uint8_t*)ptr2 + i * sizeof(__m512i);
+		__m512i tmp = _mm512_loadu_si512(src1);
+		_mm512_storeu_si512(src1, _mm512_loadu_si512(src2));
+		_mm512_storeu_si512(src2, tmp);
 	}
 
-	// ... and swap the remaining bytes with the generic swap ...
-	uint8_t* s1 = (uint8_t*)ptr1 + chunks * sizeof(__m256);
-	uint8_t* s2 = (uint8_t*)ptr2 + chunks * sizeof(__m256);
-	memswap_generic(s1, s2, bytes % sizeof(__m256));
+	// ... and swap the remaining bytes with masked loads/stores, masked out bytes are never touched so this
+	//     is safe even at the end of a page ...
+	size_t rest = bytes % sizeof(__m512i);
+	if(rest == 0)
+		return;
+
+	uint8_t* s1 = (uint8_t*)ptr1 + chunks * sizeof(__m512i);
+	uint8_t* s2 = (uint8_t*)ptr2 + chunks * sizeof(__m512i);
+	__mmask64 mask = (__mmask64)((1ull << rest) - 1);
+	__m512i tmp1 = _mm512_maskz_loadu_epi8(mask, s1);
+	__m512i tmp2 = _mm512_maskz_loadu_epi8(mask, s2);
+	_mm512_mask_storeu_epi8(s1, mask, tmp2);
+	_mm512_mask_storeu_epi8(s2, mask, tmp1);
 }
 
-inline void memswap_sse2_unroll( void* ptr1, void* ptr2, size_t bytes )
+MEMCPY_UTIL_TARGET_AVX512
+inline void memswap_avx512_unroll( void* ptr1, void* ptr2, size_t bytes )
 {
-	size_t chunks = bytes / (sizeof(__m128) * 4);
+	size_t chunks = bytes / (sizeof(__m512i) * MEMCPY_UTIL_MEMSWAP_UNROLL);
 
 	for(size_t i = 0; i < chunks; ++i)
 	{
-		float* src1_0 = (float*)((uint8_t*)ptr1 + (i * 4 + 0) * sizeof(__m128));
-		float* src1_1 = (float*)((uint8_t*)ptr1 + (i * 4 + 1) * sizeof(__m128));
-		float* src1_2 = (float*)((uint8_t*)ptr1 + (i * 4 + 2) * sizeof(__m128));
-		float* src1_3 = (float*)((uint8_t*)ptr1 + (i * 4 + 3) * sizeof(__m128));
-		float* src2_0 = (float*)((uint8_t*)ptr2 + (i * 4 + 0) * sizeof(__m128));
-		float* src2_1 = (float*)((uint8_t*)ptr2 + (i * 4 + 1) * sizeof(__m128));
-		float* src2_2 = (float*)((uint8_t*)ptr2 + (i * 4 + 2) * sizeof(__m128));
-		float* src2_3 = (float*)((uint8_t*)ptr2 + (i * 4 + 3) * sizeof(__m128));
-		__m128 tmp0 = _mm_loadu_ps(src1_0);
-		__m128 tmp1 = _mm_loadu_ps(src1_1);
-		__m128 tmp2 = _mm_loadu_ps(src1_2);
-		__m128 tmp3 = _mm_loadu_ps(src1_3);
-		_mm_storeu_ps(src1_0, _mm_loadu_ps(src2_0));
-		_mm_storeu_ps(src1_1, _mm_loadu_ps(src2_1));
-		_mm_storeu_ps(src1_2, _mm_loadu_ps(src2_2));
-		_mm_storeu_ps(src1_3, _mm_loadu_ps(src2_3));
-		_mm_storeu_ps(src2_0, tmp0);
-		_mm_storeu_ps(src2_1, tmp1);
-		_mm_storeu_ps(src2_2, tmp2);
-		_mm_storeu_ps(src2_3, tmp3);
+		uint8_t* src1 = (uint8_t*)ptr1 + i * MEMCPY_UTIL_MEMSWAP_UNROLL * sizeof(__m512i);
+		uint8_t* src2 = (uint8_t*)ptr2 + i * MEMCPY_UTIL_MEMSWAP_UNROLL * sizeof(__m512i);
+		__m512i tmp[MEMCPY_UTIL_MEMSWAP_UNROLL];
+		MEMCPY_UTIL_UNROLL_LOOP
+		for(size_t u = 0; u < MEMCPY_UTIL_MEMSWAP_UNROLL; ++u)
+			tmp[u] = _mm512_loadu_si512(src1 + u * sizeof(__m512i));
+		MEMCPY_UTIL_UNROLL_LOOP
+		for(size_t u = 0; u < MEMCPY_UTIL_MEMSWAP_UNROLL; ++u)
+			_mm512_storeu_si512(src1 + u * sizeof(__m512i), _mm512_loadu_si512(src2 + u * sizeof(__m512i)));
+		MEMCPY_UTIL_UNROLL_LOOP
+		for(size_t u = 0; u < MEMCPY_UTIL_MEMSWAP_UNROLL; ++u)
+			_mm512_storeu_si512(src2 + u * sizeof(__m512i), tmp[u]);
 	}
 
-	// ... and swap the remaining bytes with the generic swap ...
-	size_t bytes_processed = (chunks * 4) * sizeof(__m128);
-	memswap_sse2((uint8_t*)ptr1  + bytes_processed,
-				 (uint8_t*)ptr2  + bytes_processed,
-				 bytes - bytes_processed);
+	// ... and swap the remaining bytes with the non-unrolled swap ...
+	size_t bytes_processed = (chunks * MEMCPY_UTIL_MEMSWAP_UNROLL) * sizeof(__m512i);
+	memswap_avx512((uint8_t*)ptr1  + bytes_processed,
+				   (uint8_t*)ptr2  + bytes_processed,
+				   bytes - bytes_processed);
+}
+
+// streaming kernels, swapping with non-temporal stores to not pollute the cache when swapping big buffers.
+// ptr1 is aligned to the vector-width by swapping a few bytes first and ptr2 is streamed to if it happens
+// to end up aligned as well, if not it falls back to regular unaligned stores.
+inline void memswap_sse2_stream( void* ptr1, void* ptr2, size_t bytes )
+{
+	uint8_t* s1 = (uint8_t*)ptr1;
+	uint8_t* s2 = (uint8_t*)ptr2;
+
+	// ... swap bytes until ptr1 is aligned ...
+	size_t head = memcpy_util_bytes_to_align(s1, sizeof(__m128i), bytes);
+	memswap_generic(s1, s2, head);
+	s1    += head;
+	s2    += head;
+	bytes -= head;
+
+	const bool   s2_aligned = ((uintptr_t)s2 & (sizeof(__m128i) - 1)) == 0;
+	const size_t chunks     = bytes / (sizeof(__m128i) * 4);
+	for(size_t i = 0; i < chunks; ++i)
+	{
+		__m128i* src1 = (__m128i*)(s1 + i * sizeof(__m128i) * 4);
+		__m128i* src2 = (__m128i*)(s2 + i * sizeof(__m128i) * 4);
+		_mm_prefetch((const char*)src1 + MEMCPY_UTIL_STREAM_PREFETCH_DISTANCE, _MM_HINT_NTA);
+		_mm_prefetch((const char*)src2 + MEMCPY_UTIL_STREAM_PREFETCH_DISTANCE, _MM_HINT_NTA);
+
+		__m128i tmp1_0 = _mm_load_si128(src1 + 0);
+		__m128i tmp1_1 = _mm_load_si128(src1 + 1);
+		__m128i tmp1_2 = _mm_load_si128(src1 + 2);
+		__m128i tmp1_3 = _mm_load_si128(src1 + 3);
+		__m128i tmp2_0 = _mm_loadu_si128(src2 + 0);
+		__m128i tmp2_1 = _mm_loadu_si128(src2 + 1);
+		__m128i tmp2_2 = _mm_loadu_si128(src2 + 2);
+		__m128i tmp2_3 = _mm_loadu_si128(src2 + 3);
+		_mm_stream_si128(src1 + 0, tmp2_0);
+		_mm_stream_si128(src1 + 1, tmp2_1);
+		_mm_stream_si128(src1 + 2, tmp2_2);
+		_mm_stream_si128(src1 + 3, tmp2_3);
+		if(s2_aligned)
+		{
+			_mm_stream_si128(src2 + 0, tmp1_0);
+			_mm_stream_si128(src2 + 1, tmp1_1);
+			_mm_stream_si128(src2 + 2, tmp1_2);
+			_mm_stream_si128(src2 + 3, tmp1_3);
+		}
+		else
+		{
+			_mm_storeu_si128(src2 + 0, tmp1_0);
+			_mm_storeu_si128(src2 + 1, tmp1_1);
+			_mm_storeu_si128(src2 + 2, tmp1_2);
+			_mm_storeu_si128(src2 + 3, tmp1_3);
+		}
+	}
+
+	// ... make the non-temporal stores globally visible before returning ...
+	_mm_sfence();
+
+	// ... and swap the remaining bytes with the regular swap ...
+	size_t bytes_processed = chunks * sizeof(__m128i) * 4;
+	memswap_sse2(s1 + bytes_processed, s2 + bytes_processed, bytes - bytes_processed);
 }
 
 MEMCPY_UTIL_TARGET_AVX
-inline void memswap_avx_unroll( void* ptr1, void* ptr2, size_t bytes )
+inline void memswap_avx_stream( void* ptr1, void* ptr2, size_t bytes )
 {
-	size_t chunks = bytes / (sizeof(__m256) * 4);
+	uint8_t* s1 = (uint8_t*)ptr1;
+	uint8_t* s2 = (uint8_t*)ptr2;
+
+	// ... swap bytes until ptr1 is aligned ...
+	size_t head = memcpy_util_bytes_to_align(s1, sizeof(__m256i), bytes);
+	memswap_generic(s1, s2, head);
+	s1    += head;
+	s2    += head;
+	bytes -= head;
 
+	const bool   s2_aligned = ((uintptr_t)s2 & (sizeof(__m256i) - 1)) == 0;
+	const size_t chunks     = bytes / (sizeof(__m256i) * 2);
 	for(size_t i = 0; i < chunks; ++i)
 	{
-		float* src1_0 = (float*)((uint8_t*)ptr1 + (i * 4 + 0) * sizeof(__m256));
-		float* src1_1 = (float*)((uint8_t*)ptr1 + (i * 4 + 1) * sizeof(__m256));
-		float* src1_2 = (float*)((uint8_t*)ptr1 + (i * 4 + 2) * sizeof(__m256));
-		float* src1_3 = (float*)((uint8_t*)ptr1 + (i * 4 + 3) * sizeof(__m256));
-		float* src2_0 = (float*)((uint8_t*)ptr2 + (i * 4 + 0) * sizeof(__m256));
-		float* src2_1 = (float*)((uint8_t*)ptr2 + (i * 4 + 1) * sizeof(__m256));
-		float* src2_2 = (float*)((uint8_t*)ptr2 + (i * 4 + 2) * sizeof(__m256));
-		float* src2_3 = (float*)((uint8_t*)ptr2 + (i * 4 + 3) * sizeof(__m256));
-		__m256 tmp0 = _mm256_loadu_ps(src1_0);
-		__m256 tmp1 = _mm256_loadu_ps(src1_1);
-		__m256 tmp2 = _mm256_loadu_ps(src1_2);
-		__m256 tmp3 = _mm256_loadu_ps(src1_3);
-		_mm256_storeu_ps(src1_0, _mm256_loadu_ps(src2_0));
-		_mm256_storeu_ps(src1_1, _mm256_loadu_ps(src2_1));
-		_mm256_storeu_ps(src1_2, _mm256_loadu_ps(src2_2));
-		_mm256_storeu_ps(src1_3, _mm256_loadu_ps(src2_3));
-		_mm256_storeu_ps(src2_0, tmp0);
-		_mm256_storeu_ps(src2_1, tmp1);
-		_mm256_storeu_ps(src2_2, tmp2);
-		_mm256_storeu_ps(src2_3, tmp3);
+		__m256i* src1 = (__m256i*)(s1 + i * sizeof(__m256i) * 2);
+		__m256i* src2 = (__m256i*)(s2 + i * sizeof(__m256i) * 2);
+		_mm_prefetch((const char*)src1 + MEMCPY_UTIL_STREAM_PREFETCH_DISTANCE, _MM_HINT_NTA);
+		_mm_prefetch((const char*)src2 + MEMCPY_UTIL_STREAM_PREFETCH_DISTANCE, _MM_HINT_NTA);
+
+		__m256i tmp1_0 = _mm256_load_si256(src1 + 0);
+		__m256i tmp1_1 = _mm256_load_si256(src1 + 1);
+		__m256i tmp2_0 = _mm256_loadu_si256(src2 + 0);
+		__m256i tmp2_1 = _mm256_loadu_si256(src2 + 1);
+		_mm256_stream_si256(src1 + 0, tmp2_0);
+		_mm256_stream_si256(src1 + 1, tmp2_1);
+		if(s2_aligned)
+		{
+			_mm256_stream_si256(src2 + 0, tmp1_0);
+			_mm256_stream_si256(src2 + 1, tmp1_1);
+		}
+		else
+		{
+			_mm256_storeu_si256(src2 + 0, tmp1_0);
+			_mm256_storeu_si256(src2 + 1, tmp1_1);
+		}
 	}
 
-	// ... and swap the remaining bytes with the generic swap ...
-	size_t bytes_processed = (chunks * 4) * sizeof(__m256);
-	memswap_avx((uint8_t*)ptr1  + bytes_processed,
-				(uint8_t*)ptr2  + bytes_processed,
-				bytes - bytes_processed);
-};
+	// ... make the non-temporal stores globally visible before returning ...
+	_mm_sfence();
+
+	// ... and swap the remaining bytes with the regular swap ...
+	size_t bytes_processed = chunks * sizeof(__m256i) * 2;
+	memswap_avx(s1 + bytes_processed, s2 + bytes_processed, bytes - bytes_processed);
+}
 
 inline bool memcpy_util_has_avx()
 {
@@ -466,40 +983,202 @@ inline bool memcpy_util_has_avx()
 #endif
 }
 
-inline bool memcpy_util_has_sse2()
+inline bool memcpy_util_has_avx2()
 {
 #if defined(_MSC_VER)
 	return false; // TODO: implement for MSVC
 #else
-	return __builtin_cpu_supports("sse2");
+	return __builtin_cpu_supports("avx2");
 #endif
 }
 
-#if defined(__AVX__)
-#  define MEMCPY_UTIL_HAS_AVX
-#endif
-
-#if defined(__SSE2__)
-#  define MEMCPY_UTIL_HAS_SSE2
+inline bool memcpy_util_has_ssse3()
+{
+#if defined(_MSC_VER)
+	return false; // TODO: implement for MSVC
+#else
+	return __builtin_cpu_supports("ssse3");
 #endif
+}
 
-inline void memswap( void* ptr1, void* ptr2, size_t bytes )
+inline bool memcpy_util_has_avx512()
+{
+#if defined(_MSC_VER)
+	return false; // TODO: implement for MSVC
+#else
+	return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+}
+
+inline bool memcpy_util_has_sse2()
+{
+#if defined(_MSC_VER)
+	return false; // TODO: implement for MSVC
+#else
+	return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#if defined(__AVX512F__) && defined(__AVX512BW__)
+#  define MEMCPY_UTIL_HAS_AVX512
+#endif
+
+#if defined(__AVX__)
+#  define MEMCPY_UTIL_HAS_AVX
+#endif
+
+#if defined(__SSE2__)
+#  define MEMCPY_UTIL_HAS_SSE2
+#endif
+
+inline bool memswap_kernel_supported( memswap_kernel kernel )
 {
+	switch(kernel)
+	{
+		case MEMSWAP_KERNEL_GENERIC:
+		case MEMSWAP_KERNEL_MEMCPY:
+			return true;
+		case MEMSWAP_KERNEL_SSE2:
+		case MEMSWAP_KERNEL_SSE2_UNROLL:
+		case MEMSWAP_KERNEL_SSE2_STREAM:
+#if defined(MEMCPY_UTIL_HAS_SSE2)
+			return true;
+#else
+			return memcpy_util_has_sse2();
+#endif
+		case MEMSWAP_KERNEL_AVX:
+		case MEMSWAP_KERNEL_AVX_UNROLL:
+		case MEMSWAP_KERNEL_AVX_STREAM:
 #if defined(MEMCPY_UTIL_HAS_AVX)
-	memswap_avx_unroll(ptr1, ptr2, bytes);
-#elif defined(MEMCPY_UTIL_HAS_SSE2)
-	if(memcpy_util_has_avx())
-		memswap_avx_unroll(ptr1, ptr2, bytes);
-	else
-		memswap_sse2_unroll(ptr1, ptr2, bytes);
+			return true;
 #else
-	if(memcpy_util_has_avx())
-		memswap_avx_unroll(ptr1, ptr2, bytes);
-	else if(memcpy_util_has_sse2())
-		memswap_sse2_unroll(ptr1, ptr2, bytes);
-	else
-		memswap_memcpy(ptr1, ptr2, bytes);
+			return memcpy_util_has_avx();
 #endif
+		case MEMSWAP_KERNEL_AVX512:
+		case MEMSWAP_KERNEL_AVX512_UNROLL:
+#if defined(MEMCPY_UTIL_HAS_AVX512)
+			return true;
+#else
+			return memcpy_util_has_avx512();
+#endif
+		default:
+			return false;
+	}
+}
+
+inline memswap_kernel memswap_best_kernel()
+{
+	if(memswap_kernel_supported(MEMSWAP_KERNEL_AVX512_UNROLL))
+		return MEMSWAP_KERNEL_AVX512_UNROLL;
+	if(memswap_kernel_supported(MEMSWAP_KERNEL_AVX_UNROLL))
+		return MEMSWAP_KERNEL_AVX_UNROLL;
+	if(memswap_kernel_supported(MEMSWAP_KERNEL_SSE2_UNROLL))
+		return MEMSWAP_KERNEL_SSE2_UNROLL;
+	return MEMSWAP_KERNEL_MEMCPY;
+}
+
+// kernel used by memswap() for swaps bigger than the stream threshold.
+inline memswap_kernel memswap_best_stream_kernel()
+{
+	if(memswap_kernel_supported(MEMSWAP_KERNEL_AVX_STREAM))
+		return MEMSWAP_KERNEL_AVX_STREAM;
+	if(memswap_kernel_supported(MEMSWAP_KERNEL_SSE2_STREAM))
+		return MEMSWAP_KERNEL_SSE2_STREAM;
+	return MEMSWAP_KERNEL_MEMCPY;
+}
+
+inline const char* memswap_kernel_name( memswap_kernel kernel )
+{
+	switch(kernel)
+	{
+		case MEMSWAP_KERNEL_GENERIC:       return "generic";
+		case MEMSWAP_KERNEL_MEMCPY:        return "memcpy";
+		case MEMSWAP_KERNEL_SSE2:          return "sse2";
+		case MEMSWAP_KERNEL_SSE2_UNROLL:   return "sse2_unroll";
+		case MEMSWAP_KERNEL_AVX:           return "avx";
+		case MEMSWAP_KERNEL_AVX_UNROLL:    return "avx_unroll";
+		case MEMSWAP_KERNEL_AVX512:        return "avx512";
+		case MEMSWAP_KERNEL_AVX512_UNROLL: return "avx512_unroll";
+		case MEMSWAP_KERNEL_SSE2_STREAM:   return "sse2_stream";
+		case MEMSWAP_KERNEL_AVX_STREAM:    return "avx_stream";
+		default:                           return "unknown";
+	}
+}
+
+typedef void (*memswap_func_t)( void* ptr1, void* ptr2, size_t bytes );
+
+inline memswap_func_t memswap_kernel_func( memswap_kernel kernel )
+{
+	switch(kernel)
+	{
+		case MEMSWAP_KERNEL_GENERIC:       return memswap_generic;
+		case MEMSWAP_KERNEL_MEMCPY:        return memswap_memcpy;
+		case MEMSWAP_KERNEL_SSE2:          return memswap_sse2;
+		case MEMSWAP_KERNEL_SSE2_UNROLL:   return memswap_sse2_unroll;
+		case MEMSWAP_KERNEL_AVX:           return memswap_avx;
+		case MEMSWAP_KERNEL_AVX_UNROLL:    return memswap_avx_unroll;
+		case MEMSWAP_KERNEL_AVX512:        return memswap_avx512;
+		case MEMSWAP_KERNEL_AVX512_UNROLL: return memswap_avx512_unroll;
+		case MEMSWAP_KERNEL_SSE2_STREAM:   return memswap_sse2_stream;
+		case MEMSWAP_KERNEL_AVX_STREAM:    return memswap_avx_stream;
+		default:                           return memswap_memcpy;
+	}
+}
+
+struct memcpy_util_dispatch
+{
+	memswap_kernel swap_kernel;
+	memswap_func_t swap;
+	memswap_func_t swap_stream;
+	size_t         swap_stream_threshold;
+};
+
+// the dispatch table is resolved once, on first use, instead of querying the cpu on every call.
+inline memcpy_util_dispatch& memcpy_util_dispatch_table()
+{
+	static memcpy_util_dispatch table = {
+		memswap_best_kernel(),
+		memswap_kernel_func(memswap_best_kernel()),
+		memswap_kernel_func(memswap_best_stream_kernel()),
+		MEMCPY_UTIL_MEMSWAP_STREAM_THRESHOLD
+	};
+	return table;
+}
+
+inline memswap_kernel memswap_get_kernel()
+{
+	return memcpy_util_dispatch_table().swap_kernel;
+}
+
+inline bool memswap_set_kernel( memswap_kernel kernel )
+{
+	if(!memswap_kernel_supported(kernel))
+		return false;
+
+	memcpy_util_dispatch& table = memcpy_util_dispatch_table();
+	table.swap_kernel = kernel;
+	table.swap        = memswap_kernel_func(kernel);
+	table.swap_stream = memswap_kernel_func(kernel == memswap_best_kernel() ? memswap_best_stream_kernel() : kernel);
+	return true;
+}
+
+inline void memswap_set_stream_threshold( size_t bytes )
+{
+	memcpy_util_dispatch_table().swap_stream_threshold = bytes;
+}
+
+inline size_t memswap_get_stream_threshold()
+{
+	return memcpy_util_dispatch_table().swap_stream_threshold;
+}
+
+inline void memswap( void* ptr1, void* ptr2, size_t bytes )
+{
+	const memcpy_util_dispatch& table = memcpy_util_dispatch_table();
+	if(bytes >= table.swap_stream_threshold)
+		table.swap_stream(ptr1, ptr2, bytes);
+	else
+		table.swap(ptr1, ptr2, bytes);
 }
 
 inline void* memcpy_rect( void* dst, void* src, size_t lines, size_t linelen, size_t dststride, size_t srcstride )
@@ -512,318 +1191,1592 @@ inline void* memcpy_rect( void* dst, void* src, size_t lines, size_t linelen, si
 	return dst;
 }
 
+struct memswap_parallel_job_data
+{
+	uint8_t* ptr1;
+	uint8_t* ptr2;
+	size_t   bytes;
+	size_t   bytes_per_job;
+};
+
+// offset where job starts, aligned so that all jobs except the first start on a new cache-line in ptr1.
+inline size_t memswap_parallel_job_start( const memswap_parallel_job_data* data, size_t job_index )
+{
+	if( job_index == 0 )
+		return 0;
+	size_t start = job_index * data->bytes_per_job;
+	if( start >= data->bytes )
+		return data->bytes;
+	start += memcpy_util_bytes_to_align( data->ptr1 + start, 64, data->bytes - start );
+	return start;
+}
+
+inline void memswap_parallel_job( void* job_data, size_t job_index )
+{
+	const memswap_parallel_job_data* data = (const memswap_parallel_job_data*)job_data;
+	size_t start = memswap_parallel_job_start( data, job_index );
+	size_t end   = memswap_parallel_job_start( data, job_index + 1 );
+	memswap( data->ptr1 + start, data->ptr2 + start, end - start );
+}
+
+inline void memswap_parallel( void* ptr1, void* ptr2, size_t bytes, const memcpy_util_parallel* par )
+{
+	if( par == 0 || par->job_count <= 1 || bytes < par->min_bytes )
+	{
+		memswap( ptr1, ptr2, bytes );
+		return;
+	}
+
+	// ... make sure that the dispatch-table is resolved before any jobs start ...
+	memcpy_util_dispatch_table();
+
+	memswap_parallel_job_data data;
+	data.ptr1          = (uint8_t*)ptr1;
+	data.ptr2          = (uint8_t*)ptr2;
+	data.bytes         = bytes;
+	data.bytes_per_job = ( bytes + par->job_count - 1 ) / par->job_count;
+	par->parallel_for( memswap_parallel_job, &data, par->job_count, par->userdata );
+}
+
+struct memcpy_rect_parallel_job_data
+{
+	uint8_t* dst;
+	uint8_t* src;
+	size_t   lines;
+	size_t   linelen;
+	size_t   dststride;
+	size_t   srcstride;
+	size_t   lines_per_job;
+};
+
+inline void memcpy_rect_parallel_job( void* job_data, size_t job_index )
+{
+	const memcpy_rect_parallel_job_data* data = (const memcpy_rect_parallel_job_data*)job_data;
+	size_t start = job_index * data->lines_per_job;
+	if( start >= data->lines )
+		return;
+	size_t end = start + data->lines_per_job;
+	end = end > data->lines ? data->lines : end;
+	memcpy_rect( data->dst + start * data->dststride,
+				 data->src + start * data->srcstride,
+				 end - start,
+				 data->linelen,
+				 data->dststride,
+				 data->srcstride );
+}
+
+inline void* memcpy_rect_parallel( void* dst, void* src, size_t lines, size_t linelen, size_t dststride, size_t srcstride, const memcpy_util_parallel* par )
+{
+	if( par == 0 || par->job_count <= 1 || lines < 2 || lines * linelen < par->min_bytes )
+		return memcpy_rect( dst, src, lines, linelen, dststride, srcstride );
+
+	size_t job_count = par->job_count > lines ? lines : par->job_count;
+
+	memcpy_rect_parallel_job_data data;
+	data.dst           = (uint8_t*)dst;
+	data.src           = (uint8_t*)src;
+	data.lines         = lines;
+	data.linelen       = linelen;
+	data.dststride     = dststride;
+	data.srcstride     = srcstride;
+	data.lines_per_job = ( lines + job_count - 1 ) / job_count;
+	par->parallel_for( memcpy_rect_parallel_job, &data, job_count, par->userdata );
+	return dst;
+}
+
+enum memcpy_util_overlap
+{
+	MEMCPY_UTIL_OVERLAP_NONE,    // no byte is part of both rects.
+	MEMCPY_UTIL_OVERLAP_INPLACE, // the rects are the same, same start, size and stride.
+	MEMCPY_UTIL_OVERLAP_PARTIAL  // the rects share some bytes.
+};
+
+// classify how two rects overlap, all sizes in bytes. If the strides are the same the lines of the rects are checked
+// against each other so that i.e. two sub-rects side by side in the same image is not considered overlapping, with
+// different strides only the byte-ranges spanned by the rects are checked.
+inline memcpy_util_overlap memcpy_util_rect_overlap( const void* rect1, size_t lines1, size_t linelen1, size_t stride1,
+													 const void* rect2, size_t lines2, size_t linelen2, size_t stride2 )
+{
+	if( lines1 == 0 || linelen1 == 0 || lines2 == 0 || linelen2 == 0 )
+		return MEMCPY_UTIL_OVERLAP_NONE;
+
+	if( rect1 == rect2 && lines1 == lines2 && linelen1 == linelen2 && stride1 == stride2 )
+		return MEMCPY_UTIL_OVERLAP_INPLACE;
+
+	const uintptr_t start1 = (uintptr_t)rect1;
+	const uintptr_t start2 = (uintptr_t)rect2;
+	const uintptr_t end1   = start1 + ( lines1 - 1 ) * stride1 + linelen1;
+	const uintptr_t end2   = start2 + ( lines2 - 1 ) * stride2 + linelen2;
+	if( end1 <= start2 || end2 <= start1 )
+		return MEMCPY_UTIL_OVERLAP_NONE;
+
+	if( stride1 != stride2 || linelen1 > stride1 || linelen2 > stride2 )
+		return MEMCPY_UTIL_OVERLAP_PARTIAL;
+
+	// ... same stride, line j in rect2 starts 'delta + ( j - i ) * stride' bytes after line i in rect1. Split delta
+	//     into whole lines and the offset within a line, only the two closest line-pairs can share bytes ...
+	const size_t stride = stride1;
+	if( start2 < start1 )
+		return memcpy_util_rect_overlap( rect2, lines2, linelen2, stride2, rect1, lines1, linelen1, stride1 );
+
+	const size_t delta = (size_t)( start2 - start1 );
+	const size_t q = delta / stride;
+	const size_t r = delta % stride;
+
+	// ... line i = q + j in rect1 and line j in rect2, offset r ...
+	if( r < linelen1 && q < lines1 )
+		return MEMCPY_UTIL_OVERLAP_PARTIAL;
+
+	// ... line i = q + j + 1 in rect1 and line j in rect2, offset r - stride ...
+	if( stride - r < linelen2 && q + 1 < lines1 )
+		return MEMCPY_UTIL_OVERLAP_PARTIAL;
+
+	return MEMCPY_UTIL_OVERLAP_NONE;
+}
+
 inline void* memmove_rect( void* dst, void* src, size_t lines, size_t linelen, size_t dststride, size_t srcstride )
 {
 	uint8_t* d = (uint8_t*)dst;
 	uint8_t* s = (uint8_t*)src;
 
-	// TODO: what happen if dst/src have different strides and overlap?
-
 	// ... if dst and src do not overlap, use memcpy_rect ...
-	if( d < s - ( lines * srcstride ) || d > s + ( lines * srcstride ) )
+	if( memcpy_util_rect_overlap( d, lines, linelen, dststride, s, lines, linelen, srcstride ) == MEMCPY_UTIL_OVERLAP_NONE )
 		return memcpy_rect( dst, src, lines, linelen, dststride, srcstride );
 
-	// ... if dst < src use memmove by line ...
-	else if( d >= s + srcstride + linelen )
+	// ... each line is moved with memmove so only the order of the lines matter. A dst-line that starts at or before
+	//     its src-line can only overwrite src-lines above it and need to be copied top down, one that start after its
+	//     src-line can only overwrite src-lines below it and need to be copied bottom up ...
+	#define MEMMOVE_RECT_LINE( line ) memmove( d + ( line ) * dststride, s + ( line ) * srcstride, linelen )
+
+	if( d <= s && dststride <= srcstride )
 	{
-		// ... memcpy by line, in this case there will be no intersection by line ...
+		// ... all dst-lines start at or before their src-lines ...
 		for( size_t line = 0; line < lines; ++line )
-			memcpy( d + line * dststride, s + line * srcstride, linelen );
+			MEMMOVE_RECT_LINE( line );
+	}
+	else if( d >= s && dststride >= srcstride )
+	{
+		// ... all dst-lines start at or after their src-lines ...
+		for( size_t line = lines; line > 0; --line )
+			MEMMOVE_RECT_LINE( line - 1 );
 	}
 	else if( d < s )
 	{
-		for( size_t line = 0; line < lines; ++line )
-			memmove( d + line * dststride, s + line * srcstride, linelen );
+		// ... dst catch up with src at line 'split', lines above it is copied top down and lines from it bottom up. The
+		//     two groups can not overwrite each others src-lines ...
+		size_t split = (size_t)( s - d ) / ( dststride - srcstride ) + 1;
+		if( split > lines )
+			split = lines;
+
+		for( size_t line = 0; line < split; ++line )
+			MEMMOVE_RECT_LINE( line );
+		for( size_t line = lines; line > split; --line )
+			MEMMOVE_RECT_LINE( line - 1 );
 	}
 	else
 	{
-		// ... if none of the above fits, copy lines backwards ...
-		for( int line = (int)lines - 1; line >= 0; --line )
-			memmove( d + line * (int)dststride, s + line * (int)srcstride, linelen );
+		// ... src catch up with dst at line 'split', lines above it need to be copied bottom up and lines from it top
+		//     down. A line can overwrite src-lines in the other group but only ones that are closer to their dst-line
+		//     than it is to its own, so copy from the split and outwards, the line closest to its src-line first ...
+		const size_t converge = srcstride - dststride;
+		size_t split = ( (size_t)( d - s ) + converge - 1 ) / converge;
+		if( split > lines )
+			split = lines;
+
+		size_t up   = split;
+		size_t down = split;
+		while( up > 0 || down < lines )
+		{
+			bool take_up = down == lines;
+			if( up > 0 && down < lines )
+			{
+				const size_t dist_up   = (size_t)( ( d + ( up - 1 ) * dststride ) - ( s + ( up - 1 ) * srcstride ) );
+				const size_t dist_down = (size_t)( ( s + down * srcstride ) - ( d + down * dststride ) );
+				take_up = dist_up < dist_down;
+			}
+
+			if( take_up )
+			{
+				--up;
+				MEMMOVE_RECT_LINE( up );
+			}
+			else
+			{
+				MEMMOVE_RECT_LINE( down );
+				++down;
+			}
+		}
 	}
+
+	#undef MEMMOVE_RECT_LINE
 	return dst;
 }
 
-inline void* memcpy_rectrotr( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+// prepare a memmove_-op that is done in place in dst by moving src to dst if they partially overlap. Returns false
+// if dst and src do not overlap at all, then the memcpy_-version should be used instead. Sizes in bytes.
+inline bool memcpy_util_move_to_inplace( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
 {
-	uint8_t* d = (uint8_t*)dst;
-	uint8_t* s = (uint8_t*)src;
+	memcpy_util_overlap overlap = memcpy_util_rect_overlap( dst, linecnt, linelen, dststride, src, linecnt, linelen, srcstride );
+	if( overlap == MEMCPY_UTIL_OVERLAP_NONE )
+		return false;
 
-	for( size_t line = 0; line < linecnt; ++line )
-		for( size_t byte = 0; byte < linelen; ++byte )
-			d[ ( linecnt - line ) + ( dststride * byte ) - 1 ] = s[ line * srcstride + byte ];
+	if( overlap == MEMCPY_UTIL_OVERLAP_PARTIAL )
+		memmove_rect( dst, src, linecnt, linelen, dststride, srcstride );
+	return true;
+}
 
-	return dst;
+// in-register transposes of one 16 byte wide block of items. The rows are loaded in bit-reversed order so that
+// the unpack-network leaves the items in order. Strides are in bytes and signed so that the caller can walk
+// src or dst backwards, this is what turns the transpose into a rotation.
+inline void memcpy_util_transpose_16x16_u8( uint8_t* dst, ptrdiff_t dststride, const uint8_t* src, ptrdiff_t srcstride )
+{
+	static const int order[16] = { 0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15 };
+	__m128i r[16];
+	__m128i t[16];
+	for( int i = 0; i < 16; ++i ) r[i] = _mm_loadu_si128( (const __m128i*)( src + order[i] * srcstride ) );
+	for( int i = 0; i < 8; ++i ) { t[i * 2] = _mm_unpacklo_epi8 ( r[i], r[i + 8] ); t[i * 2 + 1] = _mm_unpackhi_epi8 ( r[i], r[i + 8] ); }
+	for( int i = 0; i < 8; ++i ) { r[i * 2] = _mm_unpacklo_epi16( t[i], t[i + 8] ); r[i * 2 + 1] = _mm_unpackhi_epi16( t[i], t[i + 8] ); }
+	for( int i = 0; i < 8; ++i ) { t[i * 2] = _mm_unpacklo_epi32( r[i], r[i + 8] ); t[i * 2 + 1] = _mm_unpackhi_epi32( r[i], r[i + 8] ); }
+	for( int i = 0; i < 8; ++i ) { r[i * 2] = _mm_unpacklo_epi64( t[i], t[i + 8] ); r[i * 2 + 1] = _mm_unpackhi_epi64( t[i], t[i + 8] ); }
+	for( int i = 0; i < 16; ++i ) _mm_storeu_si128( (__m128i*)( dst + i * dststride ), r[i] );
 }
 
-inline void* memmove_rectrotr( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+inline void memcpy_util_transpose_8x8_u16( uint8_t* dst, ptrdiff_t dststride, const uint8_t* src, ptrdiff_t srcstride )
 {
-	(void)dststride; // TODO: not used, why?
-	uint8_t* d = (uint8_t*)dst;
-	uint8_t* s = (uint8_t*)src;
-	size_t image_end = linecnt * srcstride - 1;
-	for( size_t y = 0; y < linecnt / 2; ++y )
-	{
-		size_t subimage_start = y * srcstride + y;
-		size_t subimage_end   = image_end - y * srcstride - y;
-		for( size_t x = 0; x < linelen - 1; ++x )
-		{
-			size_t offset = ( x * srcstride ) + linelen - 1;
-			size_t src_p1 = subimage_start + x;
-			size_t src_p2 = subimage_start + offset;
-			size_t src_p3 = subimage_end - x;
-			size_t src_p4 = subimage_end - offset;
+	static const int order[8] = { 0, 4, 2, 6, 1, 5, 3, 7 };
+	__m128i r[8];
+	__m128i t[8];
+	for( int i = 0; i < 8; ++i ) r[i] = _mm_loadu_si128( (const __m128i*)( src + order[i] * srcstride ) );
+	for( int i = 0; i < 4; ++i ) { t[i * 2] = _mm_unpacklo_epi16( r[i], r[i + 4] ); t[i * 2 + 1] = _mm_unpackhi_epi16( r[i], r[i + 4] ); }
+	for( int i = 0; i < 4; ++i ) { r[i * 2] = _mm_unpacklo_epi32( t[i], t[i + 4] ); r[i * 2 + 1] = _mm_unpackhi_epi32( t[i], t[i + 4] ); }
+	for( int i = 0; i < 4; ++i ) { t[i * 2] = _mm_unpacklo_epi64( r[i], r[i + 4] ); t[i * 2 + 1] = _mm_unpackhi_epi64( r[i], r[i + 4] ); }
+	for( int i = 0; i < 8; ++i ) _mm_storeu_si128( (__m128i*)( dst + i * dststride ), t[i] );
+}
 
-			uint8_t swap_p1 = s[src_p1];
-			uint8_t swap_p2 = s[src_p2];
-			uint8_t swap_p3 = s[src_p3];
-			uint8_t swap_p4 = s[src_p4];
+inline void memcpy_util_transpose_4x4_u32( uint8_t* dst, ptrdiff_t dststride, const uint8_t* src, ptrdiff_t srcstride )
+{
+	__m128i r0 = _mm_loadu_si128( (const __m128i*)( src + 0 * srcstride ) );
+	__m128i r1 = _mm_loadu_si128( (const __m128i*)( src + 1 * srcstride ) );
+	__m128i r2 = _mm_loadu_si128( (const __m128i*)( src + 2 * srcstride ) );
+	__m128i r3 = _mm_loadu_si128( (const __m128i*)( src + 3 * srcstride ) );
+	__m128i t0 = _mm_unpacklo_epi32( r0, r1 );
+	__m128i t1 = _mm_unpacklo_epi32( r2, r3 );
+	__m128i t2 = _mm_unpackhi_epi32( r0, r1 );
+	__m128i t3 = _mm_unpackhi_epi32( r2, r3 );
+	_mm_storeu_si128( (__m128i*)( dst + 0 * dststride ), _mm_unpacklo_epi64( t0, t1 ) );
+	_mm_storeu_si128( (__m128i*)( dst + 1 * dststride ), _mm_unpackhi_epi64( t0, t1 ) );
+	_mm_storeu_si128( (__m128i*)( dst + 2 * dststride ), _mm_unpacklo_epi64( t2, t3 ) );
+	_mm_storeu_si128( (__m128i*)( dst + 3 * dststride ), _mm_unpackhi_epi64( t2, t3 ) );
+}
 
-			d[src_p2] = swap_p1;
-			d[src_p3] = swap_p2;
-			d[src_p4] = swap_p3;
-			d[src_p1] = swap_p4;
-		}
-		linelen -= 2;
+inline void memcpy_util_transpose_2x2_u64( uint8_t* dst, ptrdiff_t dststride, const uint8_t* src, ptrdiff_t srcstride )
+{
+	__m128i r0 = _mm_loadu_si128( (const __m128i*)( src ) );
+	__m128i r1 = _mm_loadu_si128( (const __m128i*)( src + srcstride ) );
+	_mm_storeu_si128( (__m128i*)( dst ),             _mm_unpacklo_epi64( r0, r1 ) );
+	_mm_storeu_si128( (__m128i*)( dst + dststride ), _mm_unpackhi_epi64( r0, r1 ) );
+}
+
+typedef void (*memcpy_util_transpose_func_t)( uint8_t* dst, ptrdiff_t dststride, const uint8_t* src, ptrdiff_t srcstride );
+
+// call FUNC<N>(...) with N = item_size for the common item-sizes so that all per-item copies in FUNC are done with a
+// compile time constant size, other sizes go to FUNC<0>(...) that use the runtime item_size passed in the arguments.
+#define MEMCPY_UTIL_ITEM_SIZE_DISPATCH(item_size, FUNC, ...)  \
+	switch(item_size)                                          \
+	{                                                          \
+		case 1:  FUNC<1> (__VA_ARGS__); break;                 \
+		case 2:  FUNC<2> (__VA_ARGS__); break;                 \
+		case 3:  FUNC<3> (__VA_ARGS__); break;                 \
+		case 4:  FUNC<4> (__VA_ARGS__); break;                 \
+		case 6:  FUNC<6> (__VA_ARGS__); break;                 \
+		case 8:  FUNC<8> (__VA_ARGS__); break;                 \
+		case 12: FUNC<12>(__VA_ARGS__); break;                 \
+		case 16: FUNC<16>(__VA_ARGS__); break;                 \
+		case 24: FUNC<24>(__VA_ARGS__); break;                 \
+		default: FUNC<0> (__VA_ARGS__); break;                 \
 	}
 
-	return dst;
+// transpose the items in lines [line_begin, line_end) and items [item_begin, item_end) one item at a time, strides in
+// bytes. Item 'item' in line 'line' in src is written to item 'line' in line 'item' in dst, reversed in the dst lines
+// if reverse_lines is set and with the dst lines in reverse order if reverse_items is set. Rotating right is
+// reverse_lines and rotating left is reverse_items. ITEM_SIZE == 0 means that item_size is used.
+template <size_t ITEM_SIZE>
+inline void memcpy_rectrot_items( uint8_t* d, const uint8_t* s,
+								  size_t line_begin, size_t line_end, size_t item_begin, size_t item_end,
+								  size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size,
+								  bool reverse_lines, bool reverse_items )
+{
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	for( size_t item = item_begin; item < item_end; ++item )
+	{
+		uint8_t* dst_line = reverse_items ? d + dststride * ( linelen - item - 1 )
+										  : d + dststride * item;
+		for( size_t line = line_begin; line < line_end; ++line )
+		{
+			size_t dst_item = reverse_lines ? linecnt - line - 1 : line;
+			memcpy( dst_line + dst_item * size, s + line * srcstride + item * size, size );
+		}
+	}
 }
 
-inline void* memmove_rectrotr_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+// rotate rect in tiles of MEMCPY_UTIL_ROTATE_TILE_SIZE items so that both the reads from src and the strided writes to
+// dst stay in cache. Within each tile full blocks are rotated with the in-register transposes if there is one for the
+// item-size and the rest one item at a time. Strides are in bytes, reverse_lines/reverse_items as for
+// memcpy_rectrot_items and ITEM_SIZE == 0 means that item_size is used.
+template <size_t ITEM_SIZE>
+inline void memcpy_rectrot_tiled( uint8_t* d, const uint8_t* s, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size,
+								  bool reverse_lines, bool reverse_items )
 {
-	(void)dststride; // TODO: not used, why?
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
 
-	uint8_t* d = (uint8_t*)dst;
-	uint8_t* s = (uint8_t*)src;
-	size_t image_end = linecnt * srcstride - 1;
-	for( size_t y = 0; y < linecnt / 2; ++y )
+	memcpy_util_transpose_func_t transpose = 0;
+	size_t block = 0;
+	switch(size)
 	{
-		size_t subimage_start = y * srcstride + y;
-		size_t subimage_end   = image_end - y * srcstride - y;
-		for( size_t x = 0; x < linelen - 1; ++x )
+		case 1: transpose = memcpy_util_transpose_16x16_u8;  block = 16; break;
+		case 2: transpose = memcpy_util_transpose_8x8_u16;   block = 8;  break;
+		case 4: transpose = memcpy_util_transpose_4x4_u32;   block = 4;  break;
+		case 8: transpose = memcpy_util_transpose_2x2_u64;   block = 2;  break;
+		default: break;
+	}
+
+	const ptrdiff_t sstride = (ptrdiff_t)srcstride;
+	const ptrdiff_t dstride = (ptrdiff_t)dststride;
+	const size_t tile = MEMCPY_UTIL_ROTATE_TILE_SIZE;
+	for( size_t tile_line = 0; tile_line < linecnt; tile_line += tile )
+	for( size_t tile_item = 0; tile_item < linelen; tile_item += tile )
+	{
+		const size_t line_end = tile_line + tile < linecnt ? tile_line + tile : linecnt;
+		const size_t item_end = tile_item + tile < linelen ? tile_item + tile : linelen;
+
+		// ... the part of the tile covered by full blocks ...
+		size_t block_line_end = tile_line;
+		size_t block_item_end = tile_item;
+		if( transpose )
 		{
-			size_t offset = ( x * srcstride ) + linelen - 1;
-			size_t src_p1 = subimage_start + x;
-			size_t src_p2 = subimage_start + offset;
-			size_t src_p3 = subimage_end - x;
-			size_t src_p4 = subimage_end - offset;
+			block_line_end = tile_line + ( line_end - tile_line ) / block * block;
+			block_item_end = tile_item + ( item_end - tile_item ) / block * block;
 
-			// TODO: handle bigger items than 16 bytes?
-			uint8_t swap_p1[16];
-			uint8_t swap_p2[16];
-			uint8_t swap_p3[16];
-			uint8_t swap_p4[16];
-			memcpy( swap_p1, &s[src_p1 * item_size], item_size );
-			memcpy( swap_p2, &s[src_p2 * item_size], item_size );
-			memcpy( swap_p3, &s[src_p3 * item_size], item_size );
-			memcpy( swap_p4, &s[src_p4 * item_size], item_size );
-
-			memcpy( &d[src_p2 * item_size], swap_p1, item_size );
-			memcpy( &d[src_p3 * item_size], swap_p2, item_size );
-			memcpy( &d[src_p4 * item_size], swap_p3, item_size );
-			memcpy( &d[src_p1 * item_size], swap_p4, item_size );
+			for( size_t item = tile_item; item < block_item_end; item += block )
+			for( size_t line = tile_line; line < block_line_end; line += block )
+			{
+				// ... reading the src lines bottom up reverses the order of the items in each dst line and writing the
+				//     dst lines bottom up reverses the order of the lines ...
+				const uint8_t* src_block = s + line * srcstride + item * size;
+				uint8_t*       dst_block = d + ( reverse_items ? linelen - item - 1 : item ) * dststride
+											 + ( reverse_lines ? linecnt - line - block : line ) * size;
+				transpose( dst_block, reverse_items ? -dstride : dstride,
+						   reverse_lines ? src_block + ( block - 1 ) * srcstride : src_block, reverse_lines ? -sstride : sstride );
+			}
 		}
-		linelen -= 2;
+
+		// ... and the rest of the tile one item at a time ...
+		memcpy_rectrot_items<ITEM_SIZE>( d, s, tile_line, block_line_end, block_item_end, item_end,
+										 linecnt, linelen, dststride, srcstride, size, reverse_lines, reverse_items );
+		memcpy_rectrot_items<ITEM_SIZE>( d, s, block_line_end, line_end, tile_item, item_end,
+										 linecnt, linelen, dststride, srcstride, size, reverse_lines, reverse_items );
 	}
+}
 
-	return dst;
+// memcpy_rectrotr_x/memcpy_rectrotl_x with strides in items, ITEM_SIZE == 0 means that item_size is used.
+template <size_t ITEM_SIZE>
+inline void memcpy_rectrot_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size, bool rotate_right )
+{
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	memcpy_rectrot_tiled<ITEM_SIZE>( (uint8_t*)dst, (const uint8_t*)src, linecnt, linelen, dststride * size, srcstride * size, size, rotate_right, !rotate_right );
 }
 
-inline void* memcpy_rectrotl( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+inline void* memcpy_rectrotr( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
 {
-	uint8_t* d = (uint8_t*)dst;
-	uint8_t* s = (uint8_t*)src;
+	memcpy_rectrot_tiled<1>( (uint8_t*)dst, (const uint8_t*)src, linecnt, linelen, dststride, srcstride, 1, true, false );
+	return dst;
+}
 
-	for( size_t line = 0; line < linecnt; ++line )
-		for( size_t byte = 0; byte < linelen; ++byte )
-			d[ ( linelen - byte - 1 ) * dststride + line ] = s[ line * srcstride + byte ];
+inline void* memcpy_rectrotr_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	MEMCPY_UTIL_ITEM_SIZE_DISPATCH( item_size, memcpy_rectrot_x, dst, src, linecnt, linelen, dststride, srcstride, item_size, true );
+	return dst;
+}
 
+template <size_t ITEM_SIZE>
+inline void* memcpy_rectrotr_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+{
+	static_assert( ITEM_SIZE > 0, "ITEM_SIZE need to be > 0" );
+	memcpy_rectrot_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, ITEM_SIZE, true );
 	return dst;
 }
 
-inline void* memmove_rectrotl( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+// move four items of any size in a cycle, the item at o1 in s is written to o2 in d, o2 to o3, o3 to o4 and o4 to o1.
+// The items are moved 16 bytes at a time with the rest handled in smaller chunks.
+template <size_t ITEM_SIZE>
+inline void memcpy_util_cycle4( uint8_t* d, const uint8_t* s, size_t o1, size_t o2, size_t o3, size_t o4, size_t item_size )
 {
-	(void)dststride; // TODO: not used, why?
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	size_t offset = 0;
+	for( ; offset + sizeof(__m128i) <= size; offset += sizeof(__m128i) )
+	{
+		__m128i v1 = _mm_loadu_si128( (const __m128i*)( s + o1 + offset ) );
+		__m128i v2 = _mm_loadu_si128( (const __m128i*)( s + o2 + offset ) );
+		__m128i v3 = _mm_loadu_si128( (const __m128i*)( s + o3 + offset ) );
+		__m128i v4 = _mm_loadu_si128( (const __m128i*)( s + o4 + offset ) );
+		_mm_storeu_si128( (__m128i*)( d + o2 + offset ), v1 );
+		_mm_storeu_si128( (__m128i*)( d + o3 + offset ), v2 );
+		_mm_storeu_si128( (__m128i*)( d + o4 + offset ), v3 );
+		_mm_storeu_si128( (__m128i*)( d + o1 + offset ), v4 );
+	}
 
-	uint8_t* d = (uint8_t*)dst;
-	uint8_t* s = (uint8_t*)src;
-	size_t image_end = linecnt * srcstride - 1;
+	#define MEMCPY_UTIL_CYCLE4_CHUNK(type)                                 \
+		if( offset + sizeof(type) <= size )                                \
+		{                                                                  \
+			type v1, v2, v3, v4;                                           \
+			memcpy( &v1, s + o1 + offset, sizeof(type) );                  \
+			memcpy( &v2, s + o2 + offset, sizeof(type) );                  \
+			memcpy( &v3, s + o3 + offset, sizeof(type) );                  \
+			memcpy( &v4, s + o4 + offset, sizeof(type) );                  \
+			memcpy( d + o2 + offset, &v1, sizeof(type) );                  \
+			memcpy( d + o3 + offset, &v2, sizeof(type) );                  \
+			memcpy( d + o4 + offset, &v3, sizeof(type) );                  \
+			memcpy( d + o1 + offset, &v4, sizeof(type) );                  \
+			offset += sizeof(type);                                        \
+		}
+
+	// ... less than 16 bytes left, each chunk-size is needed at most once ...
+	MEMCPY_UTIL_CYCLE4_CHUNK(uint64_t)
+	MEMCPY_UTIL_CYCLE4_CHUNK(uint32_t)
+	MEMCPY_UTIL_CYCLE4_CHUNK(uint16_t)
+	MEMCPY_UTIL_CYCLE4_CHUNK(uint8_t)
+
+	#undef MEMCPY_UTIL_CYCLE4_CHUNK
+}
+
+// rotate a square rect in place by walking its rings from the outside in and move 4 items at a time, stride in items.
+// ITEM_SIZE == 0 means that item_size is used.
+template <size_t ITEM_SIZE>
+inline void memmove_rectrot_rings( uint8_t* d, size_t linecnt, size_t stride, size_t item_size, bool rotate_right )
+{
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	size_t linelen   = linecnt;
+	size_t image_end = ( linecnt - 1 ) * stride + linecnt - 1;
 	for( size_t y = 0; y < linecnt / 2; ++y )
 	{
-		size_t subimage_start = y * srcstride + y;
-		size_t subimage_end   = image_end - y * srcstride - y;
+		size_t subimage_start = y * stride + y;
+		size_t subimage_end   = image_end - y * stride - y;
 		for( size_t x = 0; x < linelen - 1; ++x )
 		{
-			size_t offset = ( x * srcstride ) + linelen - 1;
+			size_t offset = ( x * stride ) + linelen - 1;
 			size_t src_p1 = subimage_start + x;
 			size_t src_p2 = subimage_start + offset;
 			size_t src_p3 = subimage_end - x;
 			size_t src_p4 = subimage_end - offset;
 
-			uint8_t swap_p1 = s[src_p1];
-			uint8_t swap_p2 = s[src_p2];
-			uint8_t swap_p3 = s[src_p3];
-			uint8_t swap_p4 = s[src_p4];
-
-			d[src_p4] = swap_p1;
-			d[src_p1] = swap_p2;
-			d[src_p2] = swap_p3;
-			d[src_p3] = swap_p4;
+			if( rotate_right )
+				memcpy_util_cycle4<ITEM_SIZE>( d, d, src_p1 * size, src_p2 * size, src_p3 * size, src_p4 * size, size );
+			else
+				memcpy_util_cycle4<ITEM_SIZE>( d, d, src_p1 * size, src_p4 * size, src_p3 * size, src_p2 * size, size );
 		}
 		linelen -= 2;
 	}
-
-	return dst;
 }
 
-inline void* memmove_rectrotl_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+// rotate a square rect in place a tile at a time. The rect is split in rings MEMCPY_UTIL_ROTATE_TILE_SIZE items wide and
+// the 4 sides of a ring are split in tiles that are moved 4 at a time, 3 of them directly to the next side with
+// memcpy_rectrot_tiled and one via a tile of scratch. That keeps the working set to 5 tiles instead of touching 4 far
+// apart cache-lines per item as the ring walk does. scratch is used for the tile if it is larger than the 4KB
+// stack-buffer, otherwise the tiles are shrunk to fit the stack-buffer. The center that is left when the rings are too
+// small to be split is rotated with memmove_rectrot_rings, stride in items, ITEM_SIZE == 0 means that item_size is used.
+template <size_t ITEM_SIZE>
+inline void memmove_rectrot_square_tiled( uint8_t* d, size_t n, size_t stride, size_t item_size, bool rotate_right, uint8_t* scratch, size_t scratch_size )
 {
-	(void)dststride; // TODO: not used, why?
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	uint8_t stack_tmp[4 * 1024];
+	uint8_t* tmp      = stack_tmp;
+	size_t   tmp_size = sizeof(stack_tmp);
+	if( scratch && scratch_size > tmp_size )
+	{
+		tmp      = scratch;
+		tmp_size = scratch_size;
+	}
 
-	uint8_t* d = (uint8_t*)dst;
-	uint8_t* s = (uint8_t*)src;
-	size_t image_end = linecnt * srcstride - 1;
-	for( size_t y = 0; y < linecnt / 2; ++y )
+	size_t tile = MEMCPY_UTIL_ROTATE_TILE_SIZE;
+	while( tile > 1 && tile * tile * size > tmp_size )
+		tile /= 2;
+
+	const size_t stride_bytes = stride * size;
+	#define MEMMOVE_RECTROT_AT( line, item ) ( d + ( line ) * stride_bytes + ( item ) * size )
+
+	size_t y = 0;
+	for( ; tile >= 4 && n - 2 * y >= 2 * tile; y += tile )
 	{
-		size_t subimage_start = y * srcstride + y;
-		size_t subimage_end   = image_end - y * srcstride - y;
-		for( size_t x = 0; x < linelen - 1; ++x )
+		// ... tile p1 is in the top side, T lines of w items, and is rotated right to p2 in the right side, w lines of
+		//     T items, on to p3 in the bottom and p4 in the left side ...
+		for( size_t x = y; x < n - y - tile; x += tile )
 		{
-			size_t offset = ( x * srcstride ) + linelen - 1;
-			size_t src_p1 = subimage_start + x;
-			size_t src_p2 = subimage_start + offset;
-			size_t src_p3 = subimage_end - x;
-			size_t src_p4 = subimage_end - offset;
+			const size_t w = x + tile <= n - y - tile ? tile : n - y - tile - x;
+			uint8_t* p1 = MEMMOVE_RECTROT_AT( y, x );
+			uint8_t* p2 = MEMMOVE_RECTROT_AT( x, n - y - tile );
+			uint8_t* p3 = MEMMOVE_RECTROT_AT( n - y - tile, n - x - w );
+			uint8_t* p4 = MEMMOVE_RECTROT_AT( n - x - w, y );
 
-			// TODO: handle bigger items than 16 bytes?
-			uint8_t swap_p1[16];
-			uint8_t swap_p2[16];
-			uint8_t swap_p3[16];
-			uint8_t swap_p4[16];
-			memcpy( swap_p1, &s[src_p1 * item_size], item_size );
-			memcpy( swap_p2, &s[src_p2 * item_size], item_size );
-			memcpy( swap_p3, &s[src_p3 * item_size], item_size );
-			memcpy( swap_p4, &s[src_p4 * item_size], item_size );
-
-			memcpy( &d[src_p4 * item_size], swap_p1, item_size );
-			memcpy( &d[src_p1 * item_size], swap_p2, item_size );
-			memcpy( &d[src_p2 * item_size], swap_p3, item_size );
-			memcpy( &d[src_p3 * item_size], swap_p4, item_size );
+			if( rotate_right )
+			{
+				memcpy_rect( tmp, p4, w, tile * size, tile * size, stride_bytes );
+				memcpy_rectrot_tiled<ITEM_SIZE>( p4, p3, tile, w, stride_bytes, stride_bytes, size, true, false );
+				memcpy_rectrot_tiled<ITEM_SIZE>( p3, p2, w, tile, stride_bytes, stride_bytes, size, true, false );
+				memcpy_rectrot_tiled<ITEM_SIZE>( p2, p1, tile, w, stride_bytes, stride_bytes, size, true, false );
+				memcpy_rectrot_tiled<ITEM_SIZE>( p1, tmp, w, tile, stride_bytes, tile * size, size, true, false );
+			}
+			else
+			{
+				memcpy_rect( tmp, p1, tile, w * size, w * size, stride_bytes );
+				memcpy_rectrot_tiled<ITEM_SIZE>( p1, p2, w, tile, stride_bytes, stride_bytes, size, false, true );
+				memcpy_rectrot_tiled<ITEM_SIZE>( p2, p3, tile, w, stride_bytes, stride_bytes, size, false, true );
+				memcpy_rectrot_tiled<ITEM_SIZE>( p3, p4, w, tile, stride_bytes, stride_bytes, size, false, true );
+				memcpy_rectrot_tiled<ITEM_SIZE>( p4, tmp, tile, w, stride_bytes, w * size, size, false, true );
+			}
 		}
-		linelen -= 2;
 	}
 
-	return dst;
+	memmove_rectrot_rings<ITEM_SIZE>( MEMMOVE_RECTROT_AT( y, y ), n - 2 * y, stride, size, rotate_right );
+	#undef MEMMOVE_RECTROT_AT
 }
 
-inline void* memcpy_rectfliph( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+// where items are moved when rotating from src to dst, positions are counted in items from src and can be negative
+// if dst is before src.
+struct memmove_rectrot_map
 {
-	// TODO: this is slower than the memmove_-version in non-debug build as GCC inserts a call to memcpy instead of inlining it, making
-	//       memswap() the faster alternative!
-	uint8_t* d = (uint8_t*)dst;
-	uint8_t* s = (uint8_t*)src;
-	const size_t dststride_bytes = dststride * item_size;
-	const size_t srcstride_bytes = srcstride * item_size;
-	const size_t linelen_bytes   = linelen   * item_size;
-	for( size_t line = 0; line < linecnt; ++line )
-		memcpy( d + ( linecnt - 1 - line ) * dststride_bytes, s + ( line * srcstride_bytes ), linelen_bytes );
+	ptrdiff_t dst_offset;
+	ptrdiff_t linecnt;
+	ptrdiff_t linelen;
+	ptrdiff_t dststride;
+	ptrdiff_t srcstride;
+	bool      rotate_right;
+};
 
-	return dst;
+// index in src, line * linelen + item, of the item at pos or -1 if pos is not part of src.
+inline ptrdiff_t memmove_rectrot_src_index( const memmove_rectrot_map* map, ptrdiff_t pos )
+{
+	if( pos < 0 )
+		return -1;
+	ptrdiff_t line = pos / map->srcstride;
+	ptrdiff_t item = pos % map->srcstride;
+	return line < map->linecnt && item < map->linelen ? line * map->linelen + item : -1;
 }
 
-inline void* memmove_rectfliph( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+// position of the item in src that is rotated to pos or -1 if pos is not part of dst.
+inline ptrdiff_t memmove_rectrot_src_pos( const memmove_rectrot_map* map, ptrdiff_t pos )
 {
-	// TODO: it might be worth doing an overlap-check here and use memcpy_rectfliph if they don't overlap as that is WAY
-	//       faster!
-	uint8_t* d = (uint8_t*)dst;
-	uint8_t* s = (uint8_t*)src;
-	const size_t dststride_bytes = dststride * item_size;
-	const size_t srcstride_bytes = srcstride * item_size;
-	const size_t linelen_bytes   = linelen   * item_size;
-	for( size_t line = 0; line < linecnt / 2; ++line )
-		memswap( d + ( linecnt - 1 - line ) * dststride_bytes, s + ( line * srcstride_bytes ), linelen_bytes );
-
-	return dst;
+	pos -= map->dst_offset;
+	if( pos < 0 )
+		return -1;
+	ptrdiff_t dst_line = pos / map->dststride;
+	ptrdiff_t dst_item = pos % map->dststride;
+	if( dst_line >= map->linelen || dst_item >= map->linecnt )
+		return -1;
+
+	return map->rotate_right ? ( map->linecnt - dst_item - 1 ) * map->srcstride + dst_line
+							 : dst_item * map->srcstride + ( map->linelen - dst_line - 1 );
 }
 
-inline void* memcpy_rectflipv( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+// position that the src item with index 'index' is rotated to.
+inline ptrdiff_t memmove_rectrot_dst_pos( const memmove_rectrot_map* map, ptrdiff_t index )
 {
-	// TODO: handle alignment of buffers as the macro casts array to different types.
+	ptrdiff_t line = index / map->linelen;
+	ptrdiff_t item = index % map->linelen;
+	return map->rotate_right ? map->dst_offset + item * map->dststride + ( map->linecnt - line - 1 )
+							 : map->dst_offset + ( map->linelen - item - 1 ) * map->dststride + line;
+}
 
-	#define MEMCPY_RECTFLIPV_GENERIC(type)                                                     \
-		{                                                                                      \
-			uint8_t* d = (uint8_t*)dst;                                                        \
-			uint8_t* s = (uint8_t*)src;                                                        \
-			for( size_t line = 0; line < linecnt; ++line )                                     \
-			for( size_t item = 0; item < linelen; ++item )                                     \
-				d[ line * dststride + item ] = s[ line * srcstride + ( linelen - item ) - 1 ]; \
-		}
+// rotate where dst and src overlap by following the permutation from src to dst one item at a time. Items moved to a
+// place in dst that is not part of src starts a chain that ends at an item in src that is not part of dst, everything
+// else form closed cycles that are rotated through a temporary. If visited is set it has one bit per item in src to
+// track the items that are done, otherwise each cycle is walked to find if an item is the cycles first item.
+// Strides in items, ITEM_SIZE == 0 means that item_size is used.
+template <size_t ITEM_SIZE>
+inline void memmove_rectrot_cycles( uint8_t* s, const memmove_rectrot_map* map, size_t item_size, uint8_t* visited )
+{
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	#define MEMMOVE_RECTROT_ITEM( pos ) ( s + ( pos ) * (ptrdiff_t)size )
+	#define MEMMOVE_RECTROT_VISIT( index ) if( visited ) visited[( index ) / 8] = (uint8_t)( visited[( index ) / 8] | ( 1 << ( ( index ) & 7 ) ) )
 
-	switch(item_size)
+	// ... follow all chains backwards from their free end in dst ...
+	for( ptrdiff_t dst_line = 0; dst_line < map->linelen; ++dst_line )
+	for( ptrdiff_t dst_item = 0; dst_item < map->linecnt; ++dst_item )
 	{
-		case 1: MEMCPY_RECTFLIPV_GENERIC(uint8_t);  break;
-		case 2: MEMCPY_RECTFLIPV_GENERIC(uint16_t); break;
-		case 4: MEMCPY_RECTFLIPV_GENERIC(uint32_t); break;
-		case 8: MEMCPY_RECTFLIPV_GENERIC(uint64_t); break;
-		default:
+		ptrdiff_t pos = map->dst_offset + dst_line * map->dststride + dst_item;
+		if( memmove_rectrot_src_index( map, pos ) >= 0 )
+			continue;
+
+		for( ;; )
 		{
-			uint8_t* d = (uint8_t*)dst;
-			uint8_t* s = (uint8_t*)src;
-			for( size_t line = 0; line < linecnt; ++line )
-			for( size_t item = 0; item < linelen; ++item )
-				d[ (line * dststride + item) * item_size ] = s[ (line * srcstride + (linelen - item - 1)) * item_size ];
+			ptrdiff_t from = memmove_rectrot_src_pos( map, pos );
+			memcpy( MEMMOVE_RECTROT_ITEM( pos ), MEMMOVE_RECTROT_ITEM( from ), size );
+			MEMMOVE_RECTROT_VISIT( memmove_rectrot_src_index( map, from ) );
+			if( memmove_rectrot_src_pos( map, from ) < 0 )
+				break;
+			pos = from;
 		}
-		break;
 	}
+
+	// ... and rotate the cycles, items in src that is not part of dst has already been moved as the start of a chain ...
+	const ptrdiff_t item_cnt = map->linecnt * map->linelen;
+	for( ptrdiff_t index = 0; index < item_cnt; ++index )
+	{
+		const ptrdiff_t start = ( index / map->linelen ) * map->srcstride + index % map->linelen;
+		if( memmove_rectrot_src_pos( map, start ) < 0 )
+			continue;
+
+		if( visited )
+		{
+			if( visited[index / 8] & ( 1 << ( index & 7 ) ) )
+				continue;
+		}
+		else
+		{
+			// ... only rotate a cycle from its first item, stop if the walk leave src as that is a chain ...
+			ptrdiff_t pos = memmove_rectrot_dst_pos( map, index );
+			while( pos > start )
+			{
+				ptrdiff_t next = memmove_rectrot_src_index( map, pos );
+				if( next < 0 )
+					break;
+				pos = memmove_rectrot_dst_pos( map, next );
+			}
+			if( pos != start )
+				continue;
+		}
+
+		// ... move the items in chunks so that any item-size fit in tmp ...
+		uint8_t tmp[64];
+		for( size_t offset = 0; offset < size; offset += sizeof(tmp) )
+		{
+			const size_t chunk = size - offset < sizeof(tmp) ? size - offset : sizeof(tmp);
+			memcpy( tmp, MEMMOVE_RECTROT_ITEM( start ) + offset, chunk );
+			ptrdiff_t pos = start;
+			for( ;; )
+			{
+				ptrdiff_t from = memmove_rectrot_src_pos( map, pos );
+				if( from == start )
+					break;
+				memcpy( MEMMOVE_RECTROT_ITEM( pos ) + offset, MEMMOVE_RECTROT_ITEM( from ) + offset, chunk );
+				MEMMOVE_RECTROT_VISIT( memmove_rectrot_src_index( map, from ) );
+				pos = from;
+			}
+			memcpy( MEMMOVE_RECTROT_ITEM( pos ) + offset, tmp, chunk );
+		}
+		MEMMOVE_RECTROT_VISIT( index );
+	}
+
+	#undef MEMMOVE_RECTROT_ITEM
+	#undef MEMMOVE_RECTROT_VISIT
+}
+
+// rotate a rect in place where src is linecnt lines of linelen items and dst is linelen lines of linecnt items, both
+// without padding, i.e. an image rotated in its own buffer. This is an in-place transpose of the buffer viewed as a
+// m x n matrix, m = linecnt, n = linelen, split into 3 passes that each only move items within a line or a column
+// ("A Decomposition for In-place Matrix Transposition", Catanzaro et al.) with g = gcd( m, n ) and b = n / g:
+//
+// 1. rotate column c down by c / b.
+// 2. move the item in column c of each line to column ( c * m + r ) % n, r being the line it was on before 1.
+// 3. move the items in each column to the line they end up on in dst.
+//
+// lines are moved through scratch, columns are moved in bands of as many columns as fits in scratch. The flip that
+// turn the transpose into a rotation is folded into the passes by reading src bottom up, rotate right, or each line
+// right to left, rotate left. scratch need to fit max( linecnt, linelen ) items, ITEM_SIZE == 0 means that item_size
+// is used.
+template <size_t ITEM_SIZE>
+inline void memmove_rectrot_banded( uint8_t* d, size_t linecnt, size_t linelen, size_t item_size, bool rotate_right, uint8_t* scratch, size_t scratch_size )
+{
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	const size_t m    = linecnt;
+	const size_t n    = linelen;
+
+	size_t g = m;
+	for( size_t r = n; r != 0; )
+	{
+		const size_t t = g % r;
+		g = r;
+		r = t;
+	}
+	const size_t b = n / g;
+
+	// ... a band is kept to a few cache-lines per line of scratch, wider bands only makes the reads from scratch in
+	//     3 miss more ...
+	size_t band = scratch_size / ( m * size );
+	const size_t max_band = size < 256 ? 256 / size : 1;
+	band = band < max_band ? band : max_band;
+
+	#define MEMMOVE_RECTROT_AT( line, item ) ( d + ( ( line ) * n + ( item ) ) * size )
+	#define MEMMOVE_RECTROT_SCRATCH( line, item ) ( scratch + ( ( line ) * band_len + ( item ) ) * size )
+
+	// ... 1, rotate the columns of a band down. Column c in the transpose is column c in src rotating right and n - 1 - c
+	//     rotating left and all columns in a run of b columns are rotated the same ...
+	for( size_t c0 = 0; c0 < n; c0 += band )
+	{
+		const size_t band_len = n - c0 < band ? n - c0 : band;
+		memcpy_rect( scratch, MEMMOVE_RECTROT_AT( 0, c0 ), m, band_len * size, band_len * size, n * size );
+
+		for( size_t k = 0; k < band_len; )
+		{
+			const size_t c  = rotate_right ? c0 + k : n - 1 - c0 - k;
+			const size_t cb = c / b;
+			size_t run = rotate_right ? b - c % b : c % b + 1;
+			run = run < band_len - k ? run : band_len - k;
+
+			for( size_t line = 0; line < m; ++line )
+			{
+				size_t r = line + cb;
+				r = r >= m ? r - m : r;
+				const uint8_t* in = MEMMOVE_RECTROT_SCRATCH( rotate_right ? m - 1 - r : r, k );
+				if( run == 1 )
+					memcpy( MEMMOVE_RECTROT_AT( line, c0 + k ), in, size );
+				else
+					memcpy( MEMMOVE_RECTROT_AT( line, c0 + k ), in, run * size );
+			}
+			k += run;
+		}
+	}
+
+	// ... 2, scatter each line to its new columns. Walking the columns in transpose order ( c * m + r ) % n steps m % n
+	//     per column and r steps one line per run of b columns ...
+	const size_t m_mod_n = m % n;
+	const size_t r_step  = 1 % n;
+	const size_t r_wrap  = ( 1 + n - m_mod_n ) % n;
+	const ptrdiff_t in_step = rotate_right ? (ptrdiff_t)size : -(ptrdiff_t)size;
+	for( size_t line = 0; line < m; ++line )
+	{
+		memcpy( scratch, MEMMOVE_RECTROT_AT( line, 0 ), n * size );
+
+		uint8_t* out = MEMMOVE_RECTROT_AT( line, 0 );
+		const uint8_t* in = scratch + ( rotate_right ? 0 : n - 1 ) * size;
+		size_t r  = line;
+		size_t to = line % n;
+		for( size_t c0 = 0; c0 < n; c0 += b )
+		{
+			for( size_t c = 0; c < b; ++c )
+			{
+				memcpy( out + to * size, in, size );
+				in += in_step;
+				to += m_mod_n;
+				to  = to >= n ? to - n : to;
+			}
+
+			if( ++r == m )
+			{
+				r   = 0;
+				to += r_wrap;
+			}
+			else
+				to += r_step;
+			to = to >= n ? to - n : to;
+		}
+	}
+
+	// ... 3, gather the columns of a band from the lines they were rotated to in 1. Item k on a line is item r + k on
+	//     line c in the transpose, until r reach m, and was rotated down c / b ...
+	const size_t n_div_m = n / m;
+	const size_t n_mod_m = n % m;
+	for( size_t c0 = 0; c0 < n; c0 += band )
+	{
+		const size_t band_len = n - c0 < band ? n - c0 : band;
+		memcpy_rect( scratch, MEMMOVE_RECTROT_AT( 0, c0 ), m, band_len * size, band_len * size, n * size );
+
+		const size_t diag = ( band_len + 1 ) * size;
+		size_t line_r = c0 % m;
+		size_t line_c = c0 / m;
+		for( size_t line = 0; line < m; ++line )
+		{
+			uint8_t* out = MEMMOVE_RECTROT_AT( line, c0 );
+			size_t r = line_r;
+			size_t c = line_c;
+			for( size_t k = 0; k < band_len; )
+			{
+				const size_t cb  = c / b;
+				const size_t src = r >= cb ? r - cb : r + m - cb;
+				size_t run = m - r < m - src ? m - r : m - src;
+				run = run < band_len - k ? run : band_len - k;
+
+				const uint8_t* in = MEMMOVE_RECTROT_SCRATCH( src, k );
+				for( size_t i = 0; i < run; ++i )
+				{
+					memcpy( out + ( k + i ) * size, in, size );
+					in += diag;
+				}
+
+				k += run;
+				r += run;
+				if( r == m )
+				{
+					r = 0;
+					++c;
+				}
+			}
+
+			line_c += n_div_m;
+			line_r += n_mod_m;
+			if( line_r >= m )
+			{
+				line_r -= m;
+				++line_c;
+			}
+		}
+	}
+
+	#undef MEMMOVE_RECTROT_AT
+	#undef MEMMOVE_RECTROT_SCRATCH
+}
+
+// memmove_rectrotr/memmove_rectrotl, strides in items, ITEM_SIZE == 0 means that item_size is used. Returns 0 if the
+// rotation could not be done, see memmove_rectrotr_scratch.
+template <size_t ITEM_SIZE>
+inline void* memmove_rectrot_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size,
+								bool rotate_right, void* scratch, size_t scratch_size )
+{
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	uint8_t* d = (uint8_t*)dst;
+	uint8_t* s = (uint8_t*)src;
+
+	// ... if dst and src do not overlap this is a plain memcpy_rectrot_x ...
+	if( memcpy_util_rect_overlap( dst, linelen, linecnt * size, dststride * size,
+								  src, linecnt, linelen * size, srcstride * size ) == MEMCPY_UTIL_OVERLAP_NONE )
+	{
+		memcpy_rectrot_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, size, rotate_right );
+		return dst;
+	}
+
+	// ... if all of src fit in scratch, copy it there and rotate out of it, 2 passes but both of them fast ...
+	if( scratch_size >= linecnt * linelen * size )
+	{
+		memcpy_rect( scratch, src, linecnt, linelen * size, linelen * size, srcstride * size );
+		memcpy_rectrot_x<ITEM_SIZE>( dst, scratch, linecnt, linelen, dststride, linelen, size, rotate_right );
+		return dst;
+	}
+
+	// ... items in dst need to be on top of items in src to move them in place ...
+	const ptrdiff_t dst_offset = d - s;
+	if( dst_offset % (ptrdiff_t)size != 0 )
+		return 0;
+
+	// ... a square rotated in place is done tile by tile ...
+	if( d == s && linecnt == linelen && dststride == srcstride )
+	{
+		memmove_rectrot_square_tiled<ITEM_SIZE>( d, linecnt, srcstride, size, rotate_right, (uint8_t*)scratch, scratch_size );
+		return dst;
+	}
+
+	// ... an image rotated in its own buffer is transposed in bands through scratch, or a stack-buffer if the lines
+	//     are short enough ...
+	if( d == s && dststride == linecnt && srcstride == linelen )
+	{
+		uint8_t tmp[4 * 1024];
+		const size_t band_min = ( linecnt > linelen ? linecnt : linelen ) * size;
+		if( scratch && scratch_size >= band_min )
+		{
+			memmove_rectrot_banded<ITEM_SIZE>( d, linecnt, linelen, size, rotate_right, (uint8_t*)scratch, scratch_size );
+			return dst;
+		}
+		if( sizeof(tmp) >= band_min )
+		{
+			memmove_rectrot_banded<ITEM_SIZE>( d, linecnt, linelen, size, rotate_right, tmp, sizeof(tmp) );
+			return dst;
+		}
+	}
+
+	memmove_rectrot_map map;
+	map.dst_offset   = dst_offset / (ptrdiff_t)size;
+	map.linecnt      = (ptrdiff_t)linecnt;
+	map.linelen      = (ptrdiff_t)linelen;
+	map.dststride    = (ptrdiff_t)dststride;
+	map.srcstride    = (ptrdiff_t)srcstride;
+	map.rotate_right = rotate_right;
+
+	uint8_t* visited = 0;
+	const size_t visited_size = ( linecnt * linelen + 7 ) / 8;
+	if( scratch && scratch_size >= visited_size )
+	{
+		visited = (uint8_t*)scratch;
+		memset( visited, 0x0, visited_size );
+	}
+
+	memmove_rectrot_cycles<ITEM_SIZE>( s, &map, size, visited );
 	return dst;
+}
 
-	#undef MEMCPY_RECTFLIPV_GENERIC
+inline void* memmove_rectrotr( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+{
+	return memmove_rectrot_x<1>( dst, src, linecnt, linelen, dststride, srcstride, 1, true, 0, 0 );
 }
 
-inline void* memmove_rectflipv( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+inline void* memmove_rectrotr_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	void* result = 0;
+	MEMCPY_UTIL_ITEM_SIZE_DISPATCH( item_size, result = memmove_rectrot_x, dst, src, linecnt, linelen, dststride, srcstride, item_size, true, 0, 0 );
+	return result;
+}
+
+template <size_t ITEM_SIZE>
+inline void* memmove_rectrotr_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+{
+	static_assert( ITEM_SIZE > 0, "ITEM_SIZE need to be > 0" );
+	return memmove_rectrot_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, ITEM_SIZE, true, 0, 0 );
+}
+
+inline void* memmove_rectrotr_scratch( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size, void* scratch, size_t scratch_size )
+{
+	void* result = 0;
+	MEMCPY_UTIL_ITEM_SIZE_DISPATCH( item_size, result = memmove_rectrot_x, dst, src, linecnt, linelen, dststride, srcstride, item_size, true, scratch, scratch_size );
+	return result;
+}
+
+inline void* memcpy_rectrotl( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+{
+	memcpy_rectrot_tiled<1>( (uint8_t*)dst, (const uint8_t*)src, linecnt, linelen, dststride, srcstride, 1, false, true );
+	return dst;
+}
+
+inline void* memcpy_rectrotl_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	MEMCPY_UTIL_ITEM_SIZE_DISPATCH( item_size, memcpy_rectrot_x, dst, src, linecnt, linelen, dststride, srcstride, item_size, false );
+	return dst;
+}
+
+template <size_t ITEM_SIZE>
+inline void* memcpy_rectrotl_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+{
+	static_assert( ITEM_SIZE > 0, "ITEM_SIZE need to be > 0" );
+	memcpy_rectrot_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, ITEM_SIZE, false );
+	return dst;
+}
+
+inline void* memmove_rectrotl( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+{
+	return memmove_rectrot_x<1>( dst, src, linecnt, linelen, dststride, srcstride, 1, false, 0, 0 );
+}
+
+inline void* memmove_rectrotl_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	void* result = 0;
+	MEMCPY_UTIL_ITEM_SIZE_DISPATCH( item_size, result = memmove_rectrot_x, dst, src, linecnt, linelen, dststride, srcstride, item_size, false, 0, 0 );
+	return result;
+}
+
+template <size_t ITEM_SIZE>
+inline void* memmove_rectrotl_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+{
+	static_assert( ITEM_SIZE > 0, "ITEM_SIZE need to be > 0" );
+	return memmove_rectrot_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, ITEM_SIZE, false, 0, 0 );
+}
+
+inline void* memmove_rectrotl_scratch( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size, void* scratch, size_t scratch_size )
 {
-	// TODO: handle alignment of buffers as the macro casts array to different types.
-
-	#define MEMMOVE_RECTFLIPV_GENERIC(type)                                   \
-		{                                                                     \
-			type* d = (type*)dst;                                             \
-			type* s = (type*)src;                                             \
-			for( size_t line = 0; line < linecnt; ++line )                    \
-			for( size_t item = 0; item < linelen / 2; ++item )                \
-			{                                                                 \
-				type* curr_d = d + line * dststride + item;                   \
-				type* curr_s = s + line * srcstride + ( linelen - item ) - 1; \
-                                                                              \
-				type tmp = *curr_d;                                           \
-				*curr_d  = *curr_s;                                           \
-				*curr_s  = tmp;                                               \
-			}                                                                 \
+	void* result = 0;
+	MEMCPY_UTIL_ITEM_SIZE_DISPATCH( item_size, result = memmove_rectrot_x, dst, src, linecnt, linelen, dststride, srcstride, item_size, false, scratch, scratch_size );
+	return result;
+}
+
+inline void* memcpy_rectfliph( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	// TODO: this is slower than the memmove_-version in non-debug build as GCC inserts a call to memcpy instead of inlining it, making
+	//       memswap() the faster alternative!
+	uint8_t* d = (uint8_t*)dst;
+	uint8_t* s = (uint8_t*)src;
+	const size_t dststride_bytes = dststride * item_size;
+	const size_t srcstride_bytes = srcstride * item_size;
+	const size_t linelen_bytes   = linelen   * item_size;
+	for( size_t line = 0; line < linecnt; ++line )
+		memcpy( d + ( linecnt - 1 - line ) * dststride_bytes, s + ( line * srcstride_bytes ), linelen_bytes );
+
+	return dst;
+}
+
+inline void* memmove_rectfliph( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	uint8_t* d = (uint8_t*)dst;
+	uint8_t* s = (uint8_t*)src;
+	const size_t dststride_bytes = dststride * item_size;
+	const size_t srcstride_bytes = srcstride * item_size;
+	const size_t linelen_bytes   = linelen   * item_size;
+
+	if( !memcpy_util_move_to_inplace( d, s, linecnt, linelen_bytes, dststride_bytes, srcstride_bytes ) )
+		return memcpy_rectfliph( dst, src, linecnt, linelen, dststride, srcstride, item_size );
+
+	const memswap_func_t swap = memcpy_util_dispatch_table().swap;
+	for( size_t line = 0; line < linecnt / 2; ++line )
+		swap( d + ( linecnt - 1 - line ) * dststride_bytes, d + ( line * dststride_bytes ), linelen_bytes );
+
+	return dst;
+}
+
+// number of items that memcpy_util_reverse_items() reverses in one 16 byte vector, 0 if there is no kernel for the size.
+inline size_t memcpy_util_reverse_vec_items( size_t item_size )
+{
+	switch(item_size)
+	{
+		case 1: case 2: case 4: case 8: case 16: return 16 / item_size;
+		default: return 0;
+	}
+}
+
+// reverse the order of the ITEM_SIZE-byte items in v, ITEM_SIZE need to be 1, 2, 4, 8 or 16.
+template <size_t ITEM_SIZE>
+inline __m128i memcpy_util_reverse_items( __m128i v )
+{
+	switch(ITEM_SIZE)
+	{
+		case 1:
+		{
+#if defined(__SSSE3__)
+			return _mm_shuffle_epi8( v, _mm_set_epi8( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 ) );
+#else
+			// ... swap the bytes in each u16 and then reverse the u16:s ...
+			v = _mm_or_si128( _mm_srli_epi16( v, 8 ), _mm_slli_epi16( v, 8 ) );
+			v = _mm_shufflelo_epi16( v, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+			v = _mm_shufflehi_epi16( v, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+			return _mm_shuffle_epi32( v, _MM_SHUFFLE( 0, 1, 2, 3 ) );
+#endif
 		}
+		case 2:
+			v = _mm_shufflelo_epi16( v, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+			v = _mm_shufflehi_epi16( v, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+			return _mm_shuffle_epi32( v, _MM_SHUFFLE( 0, 1, 2, 3 ) );
+		case 4:  return _mm_shuffle_epi32( v, _MM_SHUFFLE( 0, 1, 2, 3 ) );
+		case 8:  return _mm_shuffle_epi32( v, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+		default: return v;
+	}
+}
 
+// number of items that memcpy_util_reverse_group() reverses in a group of 3 16 byte vectors, 0 if there is no kernel
+// for the size. These are the item-sizes made up of 3 units of 1, 2, 4 or 8 bytes, i.e. rgb-pixels.
+inline size_t memcpy_util_reverse_group_items( size_t item_size )
+{
 	switch(item_size)
 	{
-		case 1: MEMMOVE_RECTFLIPV_GENERIC(uint8_t);  break;
-		case 2: MEMMOVE_RECTFLIPV_GENERIC(uint16_t); break;
-		case 4: MEMMOVE_RECTFLIPV_GENERIC(uint32_t); break;
-		case 8: MEMMOVE_RECTFLIPV_GENERIC(uint64_t); break;
-		break;
+		case 3: case 6: case 12: case 24: return 48 / item_size;
+		default: return 0;
+	}
+}
+
+// masks for memcpy_util_reverse_group(), pick is used by the pshufb-kernel and next, keep and prev by the sse2-kernel.
+struct memcpy_util_reverse_group_masks
+{
+	__m128i pick[3][3]; // pshufb-controls, out[i] is the or of the bytes picked from each of the 3 input vectors.
+	__m128i next[3];    // unit 0 of each item is taken from unit 2 of the same item.
+	__m128i keep[3];    // unit 1 of each item stay where it is.
+	__m128i prev[3];    // unit 2 of each item is taken from unit 0 of the same item.
+};
+
+inline memcpy_util_reverse_group_masks memcpy_util_reverse_group_make_masks( size_t item_size )
+{
+	uint8_t ctrl[3][3][16];
+	memset( ctrl, 0x80, sizeof(ctrl) );
+	for( size_t i = 0; item_size && i < 48; ++i )
+	{
+		const size_t src = 48 - ( i / item_size + 1 ) * item_size + i % item_size;
+		ctrl[i / 16][src / 16][i % 16] = (uint8_t)( src % 16 );
+	}
+
+	const size_t unit = item_size / 3;
+	uint8_t masks[3][48];
+	memset( masks, 0x0, sizeof(masks) );
+	for( size_t i = 0; unit && i < 48; ++i )
+		masks[( i / unit ) % 3][i] = 0xFF;
+
+	memcpy_util_reverse_group_masks res;
+	for( int out = 0; out < 3; ++out )
+		for( int in = 0; in < 3; ++in )
+			res.pick[out][in] = _mm_loadu_si128( (const __m128i*)ctrl[out][in] );
+	for( int v = 0; v < 3; ++v )
+	{
+		res.next[v] = _mm_loadu_si128( (const __m128i*)( masks[0] + v * 16 ) );
+		res.keep[v] = _mm_loadu_si128( (const __m128i*)( masks[1] + v * 16 ) );
+		res.prev[v] = _mm_loadu_si128( (const __m128i*)( masks[2] + v * 16 ) );
+	}
+	return res;
+}
+
+// what the reverse-kernels need for an item-size, set up once per call by the rect-functions and passed down to
+// memcpy_util_reverse_line()/memcpy_util_swap_reverse_line() instead of being rebuilt, or checked, per line or group.
+struct memcpy_util_reverse_state
+{
+	memcpy_util_reverse_group_masks group;
+	bool avx2;  // reverse 1, 2, 4, 8 and 16 byte items 32 bytes at a time with avx2.
+	bool ssse3; // reverse 3 and 6 byte items with pshufb.
+};
+
+template <size_t ITEM_SIZE>
+inline memcpy_util_reverse_state memcpy_util_reverse_setup()
+{
+	memcpy_util_reverse_state res;
+	res.group = memcpy_util_reverse_group_make_masks( memcpy_util_reverse_group_items( ITEM_SIZE ) ? ITEM_SIZE : 0 );
+	res.avx2  = memcpy_util_reverse_vec_items( ITEM_SIZE ) != 0 && memcpy_util_has_avx2();
+	res.ssse3 = ( ITEM_SIZE == 3 || ITEM_SIZE == 6 ) && memcpy_util_has_ssse3();
+	return res;
+}
+
+// reverse the order of the ITEM_SIZE-byte items in the 48 bytes v0, v1, v2, ITEM_SIZE need to be 3, 6, 12 or 24.
+// masks is only used by 3 and 6 byte items.
+template <size_t ITEM_SIZE>
+inline void memcpy_util_reverse_group( __m128i& v0, __m128i& v1, __m128i& v2, const memcpy_util_reverse_group_masks& masks )
+{
+	switch(ITEM_SIZE)
+	{
+		case 24:
+		{
+			// ... 2 items of 3 u64 ...
+			__m128d d0 = _mm_castsi128_pd( v0 );
+			__m128d d1 = _mm_castsi128_pd( v1 );
+			__m128d d2 = _mm_castsi128_pd( v2 );
+			v0 = _mm_castpd_si128( _mm_shuffle_pd( d1, d2, 1 ) );
+			v1 = _mm_castpd_si128( _mm_shuffle_pd( d2, d0, 1 ) );
+			v2 = _mm_castpd_si128( _mm_shuffle_pd( d0, d1, 1 ) );
+			break;
+		}
+		case 12:
+		{
+			// ... 4 items of 3 u32, a0 a1 a2 b0 | b1 b2 c0 c1 | c2 d0 d1 d2 -> d0 d1 d2 c0 | c1 c2 b0 b1 | b2 a0 a1 a2 ...
+			__m128 f0 = _mm_castsi128_ps( v0 );
+			__m128 f1 = _mm_castsi128_ps( v1 );
+			__m128 f2 = _mm_castsi128_ps( v2 );
+			__m128 d2c0 = _mm_shuffle_ps( f2, f1, _MM_SHUFFLE( 2, 2, 3, 3 ) );
+			__m128 c1c2 = _mm_shuffle_ps( f1, f2, _MM_SHUFFLE( 0, 0, 3, 3 ) );
+			__m128 b0b1 = _mm_shuffle_ps( f0, f1, _MM_SHUFFLE( 0, 0, 3, 3 ) );
+			__m128 b2a0 = _mm_shuffle_ps( f1, f0, _MM_SHUFFLE( 0, 0, 1, 1 ) );
+			v0 = _mm_castps_si128( _mm_shuffle_ps( f2,   d2c0, _MM_SHUFFLE( 2, 0, 2, 1 ) ) );
+			v1 = _mm_castps_si128( _mm_shuffle_ps( c1c2, b0b1, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+			v2 = _mm_castps_si128( _mm_shuffle_ps( b2a0, f0,   _MM_SHUFFLE( 2, 1, 2, 0 ) ) );
+			break;
+		}
 		default:
 		{
-			uint8_t* d = (uint8_t*)dst;
-			uint8_t* s = (uint8_t*)src;
-			for( size_t line = 0; line < linecnt; ++line )
-			for( size_t item = 0; item < linelen / 2; ++item )
-			{
-				uint8_t* curr_d = d + (line * dststride + item) * item_size;
-				uint8_t* curr_s = s + (line * srcstride + (linelen - item - 1)) * item_size;
+			// ... reverse the 1 or 2 byte units of the group and the vector order, that reverse the items but also the 3
+			//     units in each item that are then swapped back by shifting the group 2 units left and right ...
+			const int SHIFT = (int)( ITEM_SIZE / 3 * 2 );
+			__m128i r0 = memcpy_util_reverse_items<ITEM_SIZE / 3>( v2 );
+			__m128i r1 = memcpy_util_reverse_items<ITEM_SIZE / 3>( v1 );
+			__m128i r2 = memcpy_util_reverse_items<ITEM_SIZE / 3>( v0 );
+
+			__m128i n0 = _mm_or_si128( _mm_srli_si128( r0, SHIFT ), _mm_slli_si128( r1, 16 - SHIFT ) );
+			__m128i n1 = _mm_or_si128( _mm_srli_si128( r1, SHIFT ), _mm_slli_si128( r2, 16 - SHIFT ) );
+			__m128i n2 = _mm_srli_si128( r2, SHIFT );
+			__m128i p0 = _mm_slli_si128( r0, SHIFT );
+			__m128i p1 = _mm_or_si128( _mm_slli_si128( r1, SHIFT ), _mm_srli_si128( r0, 16 - SHIFT ) );
+			__m128i p2 = _mm_or_si128( _mm_slli_si128( r2, SHIFT ), _mm_srli_si128( r1, 16 - SHIFT ) );
+
+			#define MEMCPY_UTIL_REVERSE_GROUP_SELECT( i ) \
+				_mm_or_si128( _mm_and_si128( r##i, masks.keep[i] ), _mm_or_si128( _mm_and_si128( n##i, masks.next[i] ), _mm_and_si128( p##i, masks.prev[i] ) ) )
+			v0 = MEMCPY_UTIL_REVERSE_GROUP_SELECT( 0 );
+			v1 = MEMCPY_UTIL_REVERSE_GROUP_SELECT( 1 );
+			v2 = MEMCPY_UTIL_REVERSE_GROUP_SELECT( 2 );
+			#undef MEMCPY_UTIL_REVERSE_GROUP_SELECT
+			break;
+		}
+	}
+}
 
-				memswap(curr_d, curr_s, item_size);
-			}
+// memcpy_util_reverse_items() on 32 bytes with avx2, ITEM_SIZE need to be 1, 2, 4, 8 or 16.
+template <size_t ITEM_SIZE>
+MEMCPY_UTIL_TARGET_AVX2
+inline __m256i memcpy_util_reverse_items_avx2( __m256i v )
+{
+	switch(ITEM_SIZE)
+	{
+		// ... 1 and 2 byte items are reversed within each 16 byte lane with vpshufb and then the lanes are swapped ...
+		case 1:
+			v = _mm256_shuffle_epi8( v, _mm256_setr_epi8( 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+														  15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 ) );
+			return _mm256_permute4x64_epi64( v, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+		case 2:
+			v = _mm256_shuffle_epi8( v, _mm256_setr_epi8( 14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+														  14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1 ) );
+			return _mm256_permute4x64_epi64( v, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+		case 4:  return _mm256_permutevar8x32_epi32( v, _mm256_setr_epi32( 7, 6, 5, 4, 3, 2, 1, 0 ) );
+		case 8:  return _mm256_permute4x64_epi64( v, _MM_SHUFFLE( 0, 1, 2, 3 ) );
+		case 16: return _mm256_permute4x64_epi64( v, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+		default: return v;
+	}
+}
+
+// write the first items of dst_line from the end of src_line reversed, 32 bytes at a time, and return the number of
+// items written. ITEM_SIZE need to be 1, 2, 4, 8 or 16.
+template <size_t ITEM_SIZE>
+MEMCPY_UTIL_TARGET_AVX2
+inline size_t memcpy_util_reverse_line_avx2( uint8_t* dst_line, const uint8_t* src_line, size_t linelen )
+{
+	const size_t vec_items = 32 / ITEM_SIZE;
+	const size_t vec_end   = linelen / vec_items * vec_items;
+	for( size_t item = 0; item < vec_end; item += vec_items )
+	{
+		__m256i v = _mm256_loadu_si256( (const __m256i*)( src_line + ( linelen - item - vec_items ) * ITEM_SIZE ) );
+		_mm256_storeu_si256( (__m256i*)( dst_line + item * ITEM_SIZE ), memcpy_util_reverse_items_avx2<ITEM_SIZE>( v ) );
+	}
+	return vec_end;
+}
+
+// memcpy_util_swap_reverse_line() on the first items, 32 bytes from each end at a time, and return the number of items
+// swapped. ITEM_SIZE need to be 1, 2, 4, 8 or 16.
+template <size_t ITEM_SIZE>
+MEMCPY_UTIL_TARGET_AVX2
+inline size_t memcpy_util_swap_reverse_line_avx2( uint8_t* line1, uint8_t* line2, size_t count, size_t linelen )
+{
+	const size_t vec_items = 32 / ITEM_SIZE;
+	const size_t vec_end   = count / vec_items * vec_items;
+	for( size_t item = 0; item < vec_end; item += vec_items )
+	{
+		uint8_t* p1 = line1 + item * ITEM_SIZE;
+		uint8_t* p2 = line2 + ( linelen - item - vec_items ) * ITEM_SIZE;
+		__m256i v1 = _mm256_loadu_si256( (const __m256i*)p1 );
+		__m256i v2 = _mm256_loadu_si256( (const __m256i*)p2 );
+		_mm256_storeu_si256( (__m256i*)p1, memcpy_util_reverse_items_avx2<ITEM_SIZE>( v2 ) );
+		_mm256_storeu_si256( (__m256i*)p2, memcpy_util_reverse_items_avx2<ITEM_SIZE>( v1 ) );
+	}
+	return vec_end;
+}
+
+// memcpy_util_reverse_group() with pshufb, picking the bytes of each output vector from the 3 input vectors.
+MEMCPY_UTIL_TARGET_SSSE3
+inline void memcpy_util_reverse_group_ssse3( __m128i& v0, __m128i& v1, __m128i& v2, const memcpy_util_reverse_group_masks& masks )
+{
+	#define MEMCPY_UTIL_REVERSE_GROUP_PICK( out ) \
+		_mm_or_si128( _mm_or_si128( _mm_shuffle_epi8( v0, masks.pick[out][0] ), _mm_shuffle_epi8( v1, masks.pick[out][1] ) ), \
+					  _mm_shuffle_epi8( v2, masks.pick[out][2] ) )
+	__m128i r0 = MEMCPY_UTIL_REVERSE_GROUP_PICK( 0 );
+	__m128i r1 = MEMCPY_UTIL_REVERSE_GROUP_PICK( 1 );
+	__m128i r2 = MEMCPY_UTIL_REVERSE_GROUP_PICK( 2 );
+	#undef MEMCPY_UTIL_REVERSE_GROUP_PICK
+	v0 = r0;
+	v1 = r1;
+	v2 = r2;
+}
+
+// memcpy_util_reverse_line_avx2() for the 48 byte groups of memcpy_util_reverse_group_ssse3().
+template <size_t ITEM_SIZE>
+MEMCPY_UTIL_TARGET_SSSE3
+inline size_t memcpy_util_reverse_line_ssse3( uint8_t* dst_line, const uint8_t* src_line, size_t linelen, const memcpy_util_reverse_group_masks& masks )
+{
+	const size_t group_items = 48 / ITEM_SIZE;
+	const size_t group_end   = linelen / group_items * group_items;
+	for( size_t item = 0; item < group_end; item += group_items )
+	{
+		const uint8_t* s = src_line + ( linelen - item - group_items ) * ITEM_SIZE;
+		uint8_t*       d = dst_line + item * ITEM_SIZE;
+		__m128i v0 = _mm_loadu_si128( (const __m128i*)( s ) );
+		__m128i v1 = _mm_loadu_si128( (const __m128i*)( s + 16 ) );
+		__m128i v2 = _mm_loadu_si128( (const __m128i*)( s + 32 ) );
+		memcpy_util_reverse_group_ssse3( v0, v1, v2, masks );
+		_mm_storeu_si128( (__m128i*)( d ),      v0 );
+		_mm_storeu_si128( (__m128i*)( d + 16 ), v1 );
+		_mm_storeu_si128( (__m128i*)( d + 32 ), v2 );
+	}
+	return group_end;
+}
+
+// memcpy_util_swap_reverse_line_avx2() for the 48 byte groups of memcpy_util_reverse_group_ssse3().
+template <size_t ITEM_SIZE>
+MEMCPY_UTIL_TARGET_SSSE3
+inline size_t memcpy_util_swap_reverse_line_ssse3( uint8_t* line1, uint8_t* line2, size_t count, size_t linelen, const memcpy_util_reverse_group_masks& masks )
+{
+	const size_t group_items = 48 / ITEM_SIZE;
+	const size_t group_end   = count / group_items * group_items;
+	for( size_t item = 0; item < group_end; item += group_items )
+	{
+		uint8_t* p1 = line1 + item * ITEM_SIZE;
+		uint8_t* p2 = line2 + ( linelen - item - group_items ) * ITEM_SIZE;
+		__m128i a0 = _mm_loadu_si128( (const __m128i*)( p1 ) );
+		__m128i a1 = _mm_loadu_si128( (const __m128i*)( p1 + 16 ) );
+		__m128i a2 = _mm_loadu_si128( (const __m128i*)( p1 + 32 ) );
+		__m128i b0 = _mm_loadu_si128( (const __m128i*)( p2 ) );
+		__m128i b1 = _mm_loadu_si128( (const __m128i*)( p2 + 16 ) );
+		__m128i b2 = _mm_loadu_si128( (const __m128i*)( p2 + 32 ) );
+		memcpy_util_reverse_group_ssse3( a0, a1, a2, masks );
+		memcpy_util_reverse_group_ssse3( b0, b1, b2, masks );
+		_mm_storeu_si128( (__m128i*)( p1 ),      b0 );
+		_mm_storeu_si128( (__m128i*)( p1 + 16 ), b1 );
+		_mm_storeu_si128( (__m128i*)( p1 + 32 ), b2 );
+		_mm_storeu_si128( (__m128i*)( p2 ),      a0 );
+		_mm_storeu_si128( (__m128i*)( p2 + 16 ), a1 );
+		_mm_storeu_si128( (__m128i*)( p2 + 32 ), a2 );
+	}
+	return group_end;
+}
+
+// write the items of src_line to dst_line in reverse order, ITEM_SIZE == 0 means that item_size is used.
+// Item-sizes with a reverse-kernel are reversed 16 bytes, or a 48 byte group, at a time, reading from the end of src_line,
+// after as much as possible has been reversed by the avx2- or ssse3-kernels if state allows it.
+template <size_t ITEM_SIZE>
+inline void memcpy_util_reverse_line( uint8_t* dst_line, const uint8_t* src_line, size_t linelen, size_t item_size, const memcpy_util_reverse_state& state )
+{
+	const size_t size        = ITEM_SIZE ? ITEM_SIZE : item_size;
+	const size_t vec_items   = memcpy_util_reverse_vec_items( ITEM_SIZE );
+	const size_t group_items = memcpy_util_reverse_group_items( ITEM_SIZE );
+	const size_t group_end   = group_items ? linelen / group_items * group_items : 0;
+	const size_t vec_end     = vec_items ? linelen / vec_items * vec_items : 0;
+
+	size_t done = 0;
+	if( state.avx2 )
+		done = memcpy_util_reverse_line_avx2<ITEM_SIZE ? ITEM_SIZE : 1>( dst_line, src_line, linelen );
+	else if( state.ssse3 )
+		done = memcpy_util_reverse_line_ssse3<ITEM_SIZE ? ITEM_SIZE : 3>( dst_line, src_line, linelen, state.group );
+
+	for( size_t item = done; item < vec_end; item += vec_items )
+	{
+		__m128i v = _mm_loadu_si128( (const __m128i*)( src_line + ( linelen - item - vec_items ) * size ) );
+		_mm_storeu_si128( (__m128i*)( dst_line + item * size ), memcpy_util_reverse_items<ITEM_SIZE>( v ) );
+	}
+
+	for( size_t item = done; item < group_end; item += group_items )
+	{
+		const uint8_t* s = src_line + ( linelen - item - group_items ) * size;
+		uint8_t*       d = dst_line + item * size;
+		__m128i v0 = _mm_loadu_si128( (const __m128i*)( s ) );
+		__m128i v1 = _mm_loadu_si128( (const __m128i*)( s + 16 ) );
+		__m128i v2 = _mm_loadu_si128( (const __m128i*)( s + 32 ) );
+		memcpy_util_reverse_group<ITEM_SIZE>( v0, v1, v2, state.group );
+		_mm_storeu_si128( (__m128i*)( d ),      v0 );
+		_mm_storeu_si128( (__m128i*)( d + 16 ), v1 );
+		_mm_storeu_si128( (__m128i*)( d + 32 ), v2 );
+	}
+
+	// ... an item-size has at most one of the kernels so only one of vec_end and group_end is non-zero ...
+	for( size_t item = vec_end + group_end; item < linelen; ++item )
+		memcpy( dst_line + item * size, src_line + ( linelen - item - 1 ) * size, size );
+}
+
+// swap the first 'count' items in line1 with the mirrored items at the end of line2. With two different lines and
+// count == linelen this reverse both lines and swap them, with line1 == line2 and count == linelen / 2 it reverse the
+// line in place. ITEM_SIZE == 0 means that item_size is used and that the items are swapped with 'swap'. Item-sizes
+// with a reverse-kernel swap 16 bytes, or a 48 byte group, from each end at a time.
+template <size_t ITEM_SIZE>
+inline void memcpy_util_swap_reverse_line( uint8_t* line1, uint8_t* line2, size_t count, size_t linelen, size_t item_size, memswap_func_t swap, const memcpy_util_reverse_state& state )
+{
+	const size_t size        = ITEM_SIZE ? ITEM_SIZE : item_size;
+	const size_t vec_items   = memcpy_util_reverse_vec_items( ITEM_SIZE );
+	const size_t group_items = memcpy_util_reverse_group_items( ITEM_SIZE );
+	const size_t group_end   = group_items ? count / group_items * group_items : 0;
+	const size_t vec_end     = vec_items ? count / vec_items * vec_items : 0;
+
+	size_t done = 0;
+	if( state.avx2 )
+		done = memcpy_util_swap_reverse_line_avx2<ITEM_SIZE ? ITEM_SIZE : 1>( line1, line2, count, linelen );
+	else if( state.ssse3 )
+		done = memcpy_util_swap_reverse_line_ssse3<ITEM_SIZE ? ITEM_SIZE : 3>( line1, line2, count, linelen, state.group );
+
+	for( size_t item = done; item < vec_end; item += vec_items )
+	{
+		uint8_t* p1 = line1 + item * size;
+		uint8_t* p2 = line2 + ( linelen - item - vec_items ) * size;
+		__m128i v1 = _mm_loadu_si128( (const __m128i*)p1 );
+		__m128i v2 = _mm_loadu_si128( (const __m128i*)p2 );
+		_mm_storeu_si128( (__m128i*)p1, memcpy_util_reverse_items<ITEM_SIZE>( v2 ) );
+		_mm_storeu_si128( (__m128i*)p2, memcpy_util_reverse_items<ITEM_SIZE>( v1 ) );
+	}
+
+	for( size_t item = done; item < group_end; item += group_items )
+	{
+		uint8_t* p1 = line1 + item * size;
+		uint8_t* p2 = line2 + ( linelen - item - group_items ) * size;
+		__m128i a0 = _mm_loadu_si128( (const __m128i*)( p1 ) );
+		__m128i a1 = _mm_loadu_si128( (const __m128i*)( p1 + 16 ) );
+		__m128i a2 = _mm_loadu_si128( (const __m128i*)( p1 + 32 ) );
+		__m128i b0 = _mm_loadu_si128( (const __m128i*)( p2 ) );
+		__m128i b1 = _mm_loadu_si128( (const __m128i*)( p2 + 16 ) );
+		__m128i b2 = _mm_loadu_si128( (const __m128i*)( p2 + 32 ) );
+		memcpy_util_reverse_group<ITEM_SIZE>( a0, a1, a2, state.group );
+		memcpy_util_reverse_group<ITEM_SIZE>( b0, b1, b2, state.group );
+		_mm_storeu_si128( (__m128i*)( p1 ),      b0 );
+		_mm_storeu_si128( (__m128i*)( p1 + 16 ), b1 );
+		_mm_storeu_si128( (__m128i*)( p1 + 32 ), b2 );
+		_mm_storeu_si128( (__m128i*)( p2 ),      a0 );
+		_mm_storeu_si128( (__m128i*)( p2 + 16 ), a1 );
+		_mm_storeu_si128( (__m128i*)( p2 + 32 ), a2 );
+	}
+
+	for( size_t item = vec_end + group_end; item < count; ++item )
+	{
+		uint8_t* p1 = line1 + item * size;
+		uint8_t* p2 = line2 + ( linelen - item - 1 ) * size;
+
+		if( ITEM_SIZE )
+		{
+			uint8_t tmp[ITEM_SIZE ? ITEM_SIZE : 1];
+			memcpy( tmp, p1,  size );
+			memcpy( p1,  p2,  size );
+			memcpy( p2,  tmp, size );
 		}
-		break;
+		else
+			swap( p1, p2, size );
 	}
+}
+
+// flip each line of the rect, strides in items. ITEM_SIZE == 0 means that item_size is used.
+template <size_t ITEM_SIZE>
+inline void memcpy_rectflipv_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	uint8_t* d = (uint8_t*)dst;
+	uint8_t* s = (uint8_t*)src;
+	const memcpy_util_reverse_state state = memcpy_util_reverse_setup<ITEM_SIZE>();
+	for( size_t line = 0; line < linecnt; ++line )
+		memcpy_util_reverse_line<ITEM_SIZE>( d + line * dststride * size, s + line * srcstride * size, linelen, size, state );
+}
+
+// memmove_rectflipv, flip the rect in place or copy it with memcpy_rectflipv if dst and src do not overlap.
+// ITEM_SIZE == 0 means that item_size is used.
+template <size_t ITEM_SIZE>
+inline void memmove_rectflipv_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	if( !memcpy_util_move_to_inplace( dst, src, linecnt, linelen * size, dststride * size, srcstride * size ) )
+	{
+		memcpy_rectflipv_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, size );
+		return;
+	}
+
+	uint8_t* d = (uint8_t*)dst;
+	const memswap_func_t swap = ITEM_SIZE ? 0 : memcpy_util_dispatch_table().swap;
+	const memcpy_util_reverse_state state = memcpy_util_reverse_setup<ITEM_SIZE>();
+	for( size_t line = 0; line < linecnt; ++line )
+	{
+		uint8_t* curr = d + line * dststride * size;
+		memcpy_util_swap_reverse_line<ITEM_SIZE>( curr, curr, linelen / 2, linelen, size, swap, state );
+	}
+}
+
+inline void* memcpy_rectflipv( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	MEMCPY_UTIL_ITEM_SIZE_DISPATCH( item_size, memcpy_rectflipv_x, dst, src, linecnt, linelen, dststride, srcstride, item_size );
+	return dst;
+}
+
+template <size_t ITEM_SIZE>
+inline void* memcpy_rectflipv( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+{
+	static_assert( ITEM_SIZE > 0, "ITEM_SIZE need to be > 0" );
+	memcpy_rectflipv_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, ITEM_SIZE );
+	return dst;
+}
+
+inline void* memmove_rectflipv( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	MEMCPY_UTIL_ITEM_SIZE_DISPATCH( item_size, memmove_rectflipv_x, dst, src, linecnt, linelen, dststride, srcstride, item_size );
 	return dst;
+}
+
+template <size_t ITEM_SIZE>
+inline void* memmove_rectflipv( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+{
+	static_assert( ITEM_SIZE > 0, "ITEM_SIZE need to be > 0" );
+	memmove_rectflipv_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, ITEM_SIZE );
+	return dst;
+}
 
-	#undef MEMMOVE_RECTFLIPV_GENERIC
+// rotate 180 deg. by writing the lines of src bottom up and each of them reversed, strides in items.
+// ITEM_SIZE == 0 means that item_size is used.
+template <size_t ITEM_SIZE>
+inline void memcpy_rectrot180_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	uint8_t* d = (uint8_t*)dst;
+	uint8_t* s = (uint8_t*)src;
+	const memcpy_util_reverse_state state = memcpy_util_reverse_setup<ITEM_SIZE>();
+	for( size_t line = 0; line < linecnt; ++line )
+		memcpy_util_reverse_line<ITEM_SIZE>( d + line * dststride * size, s + ( linecnt - line - 1 ) * srcstride * size, linelen, size, state );
 }
+
+// memmove_rectrot180, rotate in place by swapping the first and last line reversed, then the second and second to
+// last and so on, or copy with memcpy_rectrot180 if dst and src do not overlap. ITEM_SIZE == 0 means that item_size
+// is used.
+template <size_t ITEM_SIZE>
+inline void memmove_rectrot180_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	if( !memcpy_util_move_to_inplace( dst, src, linecnt, linelen * size, dststride * size, srcstride * size ) )
+	{
+		memcpy_rectrot180_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, size );
+		return;
+	}
+
+	uint8_t* d = (uint8_t*)dst;
+	const size_t stride = dststride * size;
+	const memswap_func_t swap = ITEM_SIZE ? 0 : memcpy_util_dispatch_table().swap;
+	const memcpy_util_reverse_state state = memcpy_util_reverse_setup<ITEM_SIZE>();
+	for( size_t line = 0; line < linecnt / 2; ++line )
+		memcpy_util_swap_reverse_line<ITEM_SIZE>( d + line * stride, d + ( linecnt - line - 1 ) * stride, linelen, linelen, size, swap, state );
+
+	// ... and the middle line is just reversed ...
+	if( linecnt & 1 )
+	{
+		uint8_t* middle = d + ( linecnt / 2 ) * stride;
+		memcpy_util_swap_reverse_line<ITEM_SIZE>( middle, middle, linelen / 2, linelen, size, swap, state );
+	}
+}
+
+inline void* memcpy_rectrot180( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	MEMCPY_UTIL_ITEM_SIZE_DISPATCH( item_size, memcpy_rectrot180_x, dst, src, linecnt, linelen, dststride, srcstride, item_size );
+	return dst;
+}
+
+template <size_t ITEM_SIZE>
+inline void* memcpy_rectrot180( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+{
+	static_assert( ITEM_SIZE > 0, "ITEM_SIZE need to be > 0" );
+	memcpy_rectrot180_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, ITEM_SIZE );
+	return dst;
+}
+
+inline void* memmove_rectrot180( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size )
+{
+	MEMCPY_UTIL_ITEM_SIZE_DISPATCH( item_size, memmove_rectrot180_x, dst, src, linecnt, linelen, dststride, srcstride, item_size );
+	return dst;
+}
+
+template <size_t ITEM_SIZE>
+inline void* memmove_rectrot180( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride )
+{
+	static_assert( ITEM_SIZE > 0, "ITEM_SIZE need to be > 0" );
+	memmove_rectrot180_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, ITEM_SIZE );
+	return dst;
+}
+
+// memcpy_rectorient, strides in items. ITEM_SIZE == 0 means that item_size is used.
+template <size_t ITEM_SIZE>
+inline void memcpy_rectorient_x( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size, memcpy_rect_orientation orientation )
+{
+	const size_t size = ITEM_SIZE ? ITEM_SIZE : item_size;
+	uint8_t*       d  = (uint8_t*)dst;
+	const uint8_t* s  = (const uint8_t*)src;
+	const size_t dststride_bytes = dststride * size;
+	const size_t srcstride_bytes = srcstride * size;
+	switch( orientation )
+	{
+		// ... line by line ...
+		case MEMCPY_RECT_ORIENT_IDENTITY: memcpy_rect( dst, src, linecnt, linelen * size, dststride_bytes, srcstride_bytes ); break;
+		case MEMCPY_RECT_ORIENT_FLIPH:    memcpy_rectfliph( dst, src, linecnt, linelen, dststride, srcstride, size ); break;
+		case MEMCPY_RECT_ORIENT_FLIPV:    memcpy_rectflipv_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, size ); break;
+		case MEMCPY_RECT_ORIENT_ROT180:   memcpy_rectrot180_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, size ); break;
+
+		// ... lines and items swap place, tiled ...
+		case MEMCPY_RECT_ORIENT_ROTR:       memcpy_rectrot_tiled<ITEM_SIZE>( d, s, linecnt, linelen, dststride_bytes, srcstride_bytes, size, true,  false ); break;
+		case MEMCPY_RECT_ORIENT_ROTL:       memcpy_rectrot_tiled<ITEM_SIZE>( d, s, linecnt, linelen, dststride_bytes, srcstride_bytes, size, false, true  ); break;
+		case MEMCPY_RECT_ORIENT_TRANSPOSE:  memcpy_rectrot_tiled<ITEM_SIZE>( d, s, linecnt, linelen, dststride_bytes, srcstride_bytes, size, false, false ); break;
+		case MEMCPY_RECT_ORIENT_TRANSVERSE: memcpy_rectrot_tiled<ITEM_SIZE>( d, s, linecnt, linelen, dststride_bytes, srcstride_bytes, size, true,  true  ); break;
+
+		case MEMCPY_RECT_ORIENT_COUNT:
+			break;
+	}
+}
+
+inline void* memcpy_rectorient( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, size_t item_size, memcpy_rect_orientation orientation )
+{
+	MEMCPY_UTIL_ITEM_SIZE_DISPATCH( item_size, memcpy_rectorient_x, dst, src, linecnt, linelen, dststride, srcstride, item_size, orientation );
+	return dst;
+}
+
+template <size_t ITEM_SIZE>
+inline void* memcpy_rectorient( void* dst, void* src, size_t linecnt, size_t linelen, size_t dststride, size_t srcstride, memcpy_rect_orientation orientation )
+{
+	static_assert( ITEM_SIZE > 0, "ITEM_SIZE need to be > 0" );
+	memcpy_rectorient_x<ITEM_SIZE>( dst, src, linecnt, linelen, dststride, srcstride, ITEM_SIZE, orientation );
+	return dst;
+}
+
+#undef MEMCPY_UTIL_ITEM_SIZE_DISPATCH
@@ -111,6 +111,33 @@ TEST memswap_many_sizes()
 			memswap_avx_unroll(buf_a, buf_b, i);
 			CHECK_BUFFERS
 		}
+
+		{
+			INIT_BUFFERS
+			memswap_sse2_stream(buf_a, buf_b, i);
+			CHECK_BUFFERS
+		}
+
+		{
+			INIT_BUFFERS
+			memswap_avx_stream(buf_a, buf_b, i);
+			CHECK_BUFFERS
+		}
+
+		if(memcpy_util_has_avx512())
+		{
+			{
+				INIT_BUFFERS
+				memswap_avx512(buf_a, buf_b, i);
+				CHECK_BUFFERS
+			}
+
+			{
+				INIT_BUFFERS
+				memswap_avx512_unroll(buf_a, buf_b, i);
+				CHECK_BUFFERS
+			}
+		}
 	}
 
 	#undef INIT_BUFFERS
@@ -173,6 +200,33 @@ TEST memswap_unaligned()
 			memswap_avx_unroll(buf_a + i, buf_b + i, max_size - i);
 			CHECK_BUFFERS
 		}
+
+		{
+			INIT_BUFFERS
+			memswap_sse2_stream(buf_a + i, buf_b + i, max_size - i);
+			CHECK_BUFFERS
+		}
+
+		{
+			INIT_BUFFERS
+			memswap_avx_stream(buf_a + i, buf_b + i, max_size - i);
+			CHECK_BUFFERS
+		}
+
+		if(memcpy_util_has_avx512())
+		{
+			{
+				INIT_BUFFERS
+				memswap_avx512(buf_a + i, buf_b + i, max_size - i);
+				CHECK_BUFFERS
+			}
+
+			{
+				INIT_BUFFERS
+				memswap_avx512_unroll(buf_a + i, buf_b + i, max_size - i);
+				CHECK_BUFFERS
+			}
+		}
 	}
 
 	#undef INIT_BUFFERS
@@ -181,6 +235,184 @@ TEST memswap_unaligned()
 	return GREATEST_TEST_RES_PASS;
 }
 
+TEST memswap_unaligned_mixed()
+{
+	// ... ptr1 and ptr2 with different misalignment, only one of them can be aligned by the kernels ...
+	const size_t max_size = 512;
+	uint8_t expect_a[max_size];
+	uint8_t expect_b[max_size];
+
+	for(size_t i = 0; i < max_size; ++i)
+	{
+		expect_a[i] = (uint8_t)(i & 0xF0);
+		expect_b[i] = (uint8_t)(i & 0x0F);
+	}
+
+	uint8_t buf_a[max_size];
+	uint8_t buf_b[max_size];
+
+	for(int k = 0; k < MEMSWAP_KERNEL_COUNT; ++k)
+	{
+		memswap_kernel kernel = (memswap_kernel)k;
+		if(!memswap_kernel_supported(kernel))
+			continue;
+
+		memswap_func_t swap = memswap_kernel_func(kernel);
+		for(size_t off_a = 0; off_a < 64; off_a += 3)
+		for(size_t off_b = 0; off_b < 64; off_b += 5)
+		{
+			const size_t bytes = max_size - 64 - off_a;
+			memcpy(buf_a, expect_a, max_size);
+			memcpy(buf_b, expect_b, max_size);
+			swap(buf_a + off_a, buf_b + off_b, bytes);
+			ASSERT_MEM_EQ(buf_a + off_a, expect_b + off_b, bytes);
+			ASSERT_MEM_EQ(buf_b + off_b, expect_a + off_a, bytes);
+			ASSERT_MEM_EQ(buf_a, expect_a, off_a);
+			ASSERT_MEM_EQ(buf_b, expect_b, off_b);
+		}
+	}
+
+	return GREATEST_TEST_RES_PASS;
+}
+
+TEST memswap_set_kernel()
+{
+	const size_t max_size = 512;
+	uint8_t expect_a[max_size];
+	uint8_t expect_b[max_size];
+
+	for(size_t i = 0; i < max_size; ++i)
+	{
+		expect_a[i] = (uint8_t)(i & 0xF0);
+		expect_b[i] = (uint8_t)(i & 0x0F);
+	}
+
+	uint8_t buf_a[max_size];
+	uint8_t buf_b[max_size];
+
+	const memswap_kernel org_kernel = memswap_get_kernel();
+	ASSERT_EQ(org_kernel, memswap_best_kernel());
+
+	// ... a pinned kernel should also be used above the stream threshold ...
+	const size_t org_threshold = memswap_get_stream_threshold();
+	memswap_set_stream_threshold(0);
+
+	for(int k = 0; k < MEMSWAP_KERNEL_COUNT; ++k)
+	{
+		memswap_kernel kernel = (memswap_kernel)k;
+		if(!memswap_kernel_supported(kernel))
+		{
+			ASSERT_FALSE(memswap_set_kernel(kernel));
+			continue;
+		}
+
+		ASSERT(memswap_set_kernel(kernel));
+		ASSERT_EQ(kernel, memswap_get_kernel());
+
+		for(size_t i = 0; i < 64; ++i )
+		{
+			memcpy(buf_a, expect_a, max_size);
+			memcpy(buf_b, expect_b, max_size);
+			memswap(buf_a + i, buf_b + i, max_size - i);
+			ASSERT_MEM_EQ(buf_a + i, expect_b + i, max_size - i);
+			ASSERT_MEM_EQ(buf_b + i, expect_a + i, max_size - i);
+		}
+	}
+
+	ASSERT(memswap_set_kernel(org_kernel));
+	memswap_set_stream_threshold(org_threshold);
+
+	return GREATEST_TEST_RES_PASS;
+}
+
+TEST memswap_stream_threshold()
+{
+	const size_t max_size = 512;
+	uint8_t expect_a[max_size];
+	uint8_t expect_b[max_size];
+
+	for(size_t i = 0; i < max_size; ++i)
+	{
+		expect_a[i] = (uint8_t)(i & 0xF0);
+		expect_b[i] = (uint8_t)(i & 0x0F);
+	}
+
+	uint8_t buf_a[max_size];
+	uint8_t buf_b[max_size];
+
+	const size_t org_threshold = memswap_get_stream_threshold();
+	ASSERT_EQ(org_threshold, (size_t)MEMCPY_UTIL_MEMSWAP_STREAM_THRESHOLD);
+
+	// ... force all swaps of 128 bytes or more through the streaming kernel ...
+	memswap_set_stream_threshold(128);
+	ASSERT_EQ((size_t)128, memswap_get_stream_threshold());
+
+	for(size_t i = 0; i < 64; ++i )
+	{
+		memcpy(buf_a, expect_a, max_size);
+		memcpy(buf_b, expect_b, max_size);
+		memswap(buf_a + i, buf_b + (i * 3) % 64, max_size - 64);
+		ASSERT_MEM_EQ(buf_a + i, expect_b + (i * 3) % 64, max_size - 64);
+		ASSERT_MEM_EQ(buf_b + (i * 3) % 64, expect_a + i, max_size - 64);
+	}
+
+	memswap_set_stream_threshold(org_threshold);
+
+	return GREATEST_TEST_RES_PASS;
+}
+
+// runs all jobs in order on the calling thread, enough to verify how work is split.
+static void test_parallel_for( void (*job)( void* job_data, size_t job_index ), void* job_data, size_t job_count, void* userdata )
+{
+	size_t* jobs_run = (size_t*)userdata;
+	for( size_t i = 0; i < job_count; ++i )
+		job( job_data, i );
+	*jobs_run += job_count;
+}
+
+TEST memswap_parallel_many_sizes()
+{
+	const size_t max_size = 1024;
+	uint8_t expect_a[max_size];
+	uint8_t expect_b[max_size];
+
+	for(size_t i = 0; i < max_size; ++i)
+	{
+		expect_a[i] = (uint8_t)(i & 0xF0);
+		expect_b[i] = (uint8_t)(i & 0x0F);
+	}
+
+	uint8_t buf_a[max_size];
+	uint8_t buf_b[max_size];
+
+	size_t jobs_run = 0;
+	memcpy_util_parallel par;
+	par.parallel_for = test_parallel_for;
+	par.userdata     = &jobs_run;
+	par.job_count    = 7;
+	par.min_bytes    = 0;
+
+	for(size_t i = 0; i < max_size - 64; i += 13)
+	{
+		memcpy(buf_a, expect_a, max_size);
+		memcpy(buf_b, expect_b, max_size);
+		memswap_parallel(buf_a + 3, buf_b + 7, i, &par);
+		ASSERT_MEM_EQ(buf_a + 3, expect_b + 7, i);
+		ASSERT_MEM_EQ(buf_b + 7, expect_a + 3, i);
+		ASSERT_MEM_EQ(buf_a + 3 + i, expect_a + 3 + i, max_size - 3 - i);
+		ASSERT_MEM_EQ(buf_b + 7 + i, expect_b + 7 + i, max_size - 7 - i);
+	}
+	ASSERT(jobs_run > 0);
+
+	// ... smaller than min_bytes should not use parallel_for ...
+	jobs_run = 0;
+	par.min_bytes = max_size;
+	memswap_parallel(buf_a, buf_b, max_size / 2, &par);
+	ASSERT_EQ((size_t)0, jobs_run);
+
+	return GREATEST_TEST_RES_PASS;
+}
+
 // TODO: add test for memcpy, sse2 and avx-versions, bigger and smaller!
 
 ///////////////////////////////////////////////////////////////
@@ -204,6 +436,32 @@ TEST memcpy_rect_simple()
     return GREATEST_TEST_RES_PASS;
 }
 
+TEST memcpy_rect_parallel_lines()
+{
+	uint8_t buffer[16 * 16];
+	for(size_t i = 0; i < sizeof(buffer); ++i)
+		buffer[i] = (uint8_t)i;
+
+	size_t jobs_run = 0;
+	memcpy_util_parallel par;
+	par.parallel_for = test_parallel_for;
+	par.userdata     = &jobs_run;
+	par.job_count    = 4;
+	par.min_bytes    = 0;
+
+	for(size_t lines = 1; lines <= 13; ++lines)
+	{
+		uint8_t expect[sizeof(buffer)] = {0};
+		uint8_t dst[sizeof(buffer)] = {0};
+		memcpy_rect         ( &expect[17], &buffer[2], lines, 11, 16, 16 );
+		memcpy_rect_parallel( &dst[17],    &buffer[2], lines, 11, 16, 16, &par );
+		ASSERT_MEMEQ(dst, expect);
+	}
+	ASSERT(jobs_run > 0);
+
+    return GREATEST_TEST_RES_PASS;
+}
+
 ///////////////////////////////////////////////////////////////
 //                      memcpy_rectrotr                      //
 ///////////////////////////////////////////////////////////////
@@ -284,6 +542,65 @@ TEST memcpy_rectrotr_subrect()
     return GREATEST_TEST_RES_PASS;
 }
 
+// ... bigger than one tile, with a size that is not a multiple of the tile-size ...
+TEST memcpy_rectrotr_tiled()
+{
+	const size_t linecnt = 150;
+	const size_t linelen = 70;
+	const size_t srcstride = linelen + 3;
+	const size_t dststride = linecnt + 5;
+	static uint8_t src[linecnt * srcstride];
+	static uint8_t dst[linelen * dststride];
+	static uint8_t expect[linelen * dststride];
+	for(size_t i = 0; i < sizeof(src); ++i)
+		src[i] = (uint8_t)(i * 7);
+	memset(dst, 0, sizeof(dst));
+	memset(expect, 0, sizeof(expect));
+
+	for( size_t line = 0; line < linecnt; ++line )
+		for( size_t byte = 0; byte < linelen; ++byte )
+			expect[ ( linecnt - line - 1 ) + ( dststride * byte ) ] = src[ line * srcstride + byte ];
+
+	memcpy_rectrotr( dst, src, linecnt, linelen, dststride, srcstride );
+	ASSERT_MEMEQ(dst, expect);
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+// ... all item-sizes, bigger than one tile and not a multiple of the transpose block-size ...
+TEST memcpy_rectrotr_x_item_sizes()
+{
+	const size_t linecnt   = 83;
+	const size_t linelen   = 71;
+	const size_t srcstride = linelen + 3;
+	const size_t dststride = linecnt + 5;
+	const size_t max_item_size = 16;
+	static uint8_t src[linecnt * srcstride * max_item_size];
+	static uint8_t dst[linelen * dststride * max_item_size];
+	static uint8_t expect[linelen * dststride * max_item_size];
+	for(size_t i = 0; i < sizeof(src); ++i)
+		src[i] = (uint8_t)(i * 7 + i / 251);
+
+	const size_t item_sizes[] = { 1, 2, 3, 4, 5, 6, 8, 12, 16 };
+	for( size_t i = 0; i < sizeof(item_sizes) / sizeof(item_sizes[0]); ++i )
+	{
+		const size_t item_size = item_sizes[i];
+		memset(dst, 0, sizeof(dst));
+		memset(expect, 0, sizeof(expect));
+
+		for( size_t line = 0; line < linecnt; ++line )
+			for( size_t item = 0; item < linelen; ++item )
+				memcpy( &expect[ ( ( linecnt - line - 1 ) + ( dststride * item ) ) * item_size ],
+						&src[ ( line * srcstride + item ) * item_size ],
+						item_size );
+
+		memcpy_rectrotr_x( dst, src, linecnt, linelen, dststride, srcstride, item_size );
+		ASSERT_MEMEQ(dst, expect);
+	}
+
+    return GREATEST_TEST_RES_PASS;
+}
+
 TEST memmove_rectrotr_full()
 {
 	uint8_t buffer[] = { 'a', 'b', 'c', 'd',
@@ -324,6 +641,207 @@ TEST memmove_rectrotr_big()
     return GREATEST_TEST_RES_PASS;
 }
 
+TEST memmove_rectrotr_x_item_sizes()
+{
+	const size_t size = 9;
+	const size_t max_item_size = 64;
+	uint8_t src[size * size * max_item_size];
+	uint8_t buffer[size * size * max_item_size];
+	uint8_t expect[size * size * max_item_size];
+	for(size_t i = 0; i < sizeof(src); ++i)
+		src[i] = (uint8_t)(i * 7 + i / 251);
+
+	// ... items bigger than 16 bytes used to overflow the swap-buffers ...
+	const size_t item_sizes[] = { 1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 33, 64 };
+	for( size_t i = 0; i < sizeof(item_sizes) / sizeof(item_sizes[0]); ++i )
+	{
+		const size_t item_size = item_sizes[i];
+		memcpy(buffer, src, sizeof(buffer));
+		memcpy_rectrotr_x( expect, src, size, size, size, size, item_size );
+		memmove_rectrotr_x( buffer, buffer, size, size, size, size, item_size );
+		ASSERT_MEM_EQ(buffer, expect, size * size * item_size);
+	}
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+TEST memmove_rectrotr_no_overlap()
+{
+	// ... rotating into another buffer is just a copy, also when the rect is not square ...
+	uint8_t src[6 * 4];
+	uint8_t dst[6 * 8]    = {0};
+	uint8_t expect[6 * 8] = {0};
+	for( size_t i = 0; i < sizeof(src); ++i )
+		src[i] = (uint8_t)( 'a' + i );
+
+	memmove_rectrotr( dst, src, 4, 6, 8, 6 );
+	memcpy_rectrotr( expect, src, 4, 6, 8, 6 );
+	ASSERT_MEMEQ(dst, expect);
+
+	memset( dst, 0, sizeof(dst) );
+	memset( expect, 0, sizeof(expect) );
+	memmove_rectrotr_x( dst, src, 2, 3, 4, 3, 2 );
+	memcpy_rectrotr_x( expect, src, 2, 3, 4, 3, 2 );
+	ASSERT_MEMEQ(dst, expect);
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+TEST memmove_rectrot_square_tiled()
+{
+	// ... squares big enough to be rotated in place tile by tile, with sizes that are not a multiple of the tile-size ...
+	const size_t item_sizes[] = { 1, 3, 4, 8, 16, 70 };
+	const size_t sizes[]      = { 16, 130, 200, 257 };
+	const size_t stride       = 260;
+	uint8_t* buffer = (uint8_t*)malloc( stride * stride * 70 );
+	uint8_t* expect = (uint8_t*)malloc( stride * stride * 70 );
+
+	for( size_t is = 0; is < sizeof( item_sizes ) / sizeof( item_sizes[0] ); ++is )
+	for( size_t sz = 0; sz < sizeof( sizes ) / sizeof( sizes[0] ); ++sz )
+	for( int right = 0; right < 2; ++right )
+	{
+		const size_t item_size = item_sizes[is];
+		const size_t n = sizes[sz];
+		for( size_t i = 0; i < stride * n * item_size; ++i )
+			buffer[i] = (uint8_t)( i * 7 + i / 251 );
+
+		if( right )
+		{
+			memcpy_rectrotr_x( expect, buffer, n, n, stride, stride, item_size );
+			memmove_rectrotr_x( buffer, buffer, n, n, stride, stride, item_size );
+		}
+		else
+		{
+			memcpy_rectrotl_x( expect, buffer, n, n, stride, stride, item_size );
+			memmove_rectrotl_x( buffer, buffer, n, n, stride, stride, item_size );
+		}
+
+		for( size_t line = 0; line < n; ++line )
+			ASSERT_MEM_EQ( expect + line * stride * item_size, buffer + line * stride * item_size, n * item_size );
+	}
+
+	free( buffer );
+	free( expect );
+    return GREATEST_TEST_RES_PASS;
+}
+
+TEST memmove_rectrot_non_square()
+{
+	// ... rotate non-square rects in place, with dst at different offsets and strides and with and without scratch ...
+	const size_t item_sizes[] = { 1, 2, 3, 4, 8, 12, 70 };
+	const size_t sizes[][2]   = { { 5, 9 }, { 9, 5 }, { 1, 7 }, { 6, 4 }, { 4, 4 } };
+	const size_t BUF_SIZE = 16 * 16 * 70;
+	static uint8_t buffer[BUF_SIZE];
+	static uint8_t src[BUF_SIZE];
+	static uint8_t expect[BUF_SIZE];
+	static uint8_t scratch[BUF_SIZE];
+
+	for( size_t is = 0; is < sizeof( item_sizes ) / sizeof( item_sizes[0] ); ++is )
+	for( size_t sz = 0; sz < sizeof( sizes ) / sizeof( sizes[0] ); ++sz )
+	for( size_t src_offset = 0; src_offset < 3; ++src_offset )
+	for( size_t dst_offset = 0; dst_offset < 3; ++dst_offset )
+	for( size_t dststride = 12; dststride <= 13; ++dststride )
+	for( int scratch_mode = 0; scratch_mode < 3; ++scratch_mode )
+	for( int right = 0; right < 2; ++right )
+	{
+		const size_t item_size = item_sizes[is];
+		const size_t linecnt   = sizes[sz][0];
+		const size_t linelen   = sizes[sz][1];
+		const size_t srcstride = 11;
+		const size_t scratch_size[] = { 0, ( linecnt * linelen + 7 ) / 8, linecnt * linelen * item_size };
+
+		for( size_t i = 0; i < BUF_SIZE; ++i )
+			buffer[i] = (uint8_t)( i * 7 + i / 251 );
+		memcpy( src, buffer, BUF_SIZE );
+		memset( expect, 0, BUF_SIZE );
+
+		uint8_t* s = buffer + src_offset * srcstride * item_size;
+		uint8_t* d = buffer + dst_offset * item_size;
+		void* res;
+		if( right )
+		{
+			memcpy_rectrotr_x( expect, src + src_offset * srcstride * item_size, linecnt, linelen, dststride, srcstride, item_size );
+			res = memmove_rectrotr_scratch( d, s, linecnt, linelen, dststride, srcstride, item_size, scratch_mode ? scratch : 0, scratch_size[scratch_mode] );
+		}
+		else
+		{
+			memcpy_rectrotl_x( expect, src + src_offset * srcstride * item_size, linecnt, linelen, dststride, srcstride, item_size );
+			res = memmove_rectrotl_scratch( d, s, linecnt, linelen, dststride, srcstride, item_size, scratch_mode ? scratch : 0, scratch_size[scratch_mode] );
+		}
+		ASSERT_EQ( (void*)d, res );
+
+		for( size_t line = 0; line < linelen; ++line )
+			ASSERT_MEM_EQ( expect + line * dststride * item_size, d + line * dststride * item_size, linecnt * item_size );
+	}
+
+	// ... the byte-versions work the same ...
+	for( size_t i = 0; i < BUF_SIZE; ++i )
+		buffer[i] = (uint8_t)i;
+	memcpy_rectrotr( expect, buffer, 3, 8, 3, 8 );
+	memmove_rectrotr( buffer, buffer, 3, 8, 3, 8 );
+	ASSERT_MEM_EQ( expect, buffer, 3 * 8 );
+
+	for( size_t i = 0; i < BUF_SIZE; ++i )
+		buffer[i] = (uint8_t)i;
+	memcpy_rectrotl( expect, buffer + 10, 3, 8, 3, 8 );
+	memmove_rectrotl( buffer, buffer + 10, 3, 8, 3, 8 );
+	ASSERT_MEM_EQ( expect, buffer, 3 * 8 );
+
+	// ... dst overlapping src by less than an item can only be rotated via scratch ...
+	ASSERT_EQ( (void*)0, memmove_rectrotr_scratch( buffer + 1, buffer, 3, 5, 3, 5, 4, 0, 0 ) );
+	ASSERT_EQ( (void*)0, memmove_rectrotr_x( buffer + 1, buffer, 3, 5, 3, 5, 4 ) );
+	ASSERT_EQ( (void*)0, memmove_rectrotl_x( buffer + 1, buffer, 3, 5, 3, 5, 4 ) );
+	ASSERT_EQ( (void*)0, memmove_rectrotr_x<4>( buffer + 1, buffer, 3, 5, 3, 5 ) );
+	ASSERT_EQ( (void*)0, memmove_rectrotl_x<4>( buffer + 1, buffer, 3, 5, 3, 5 ) );
+	ASSERT_EQ( (void*)( buffer + 1 ), memmove_rectrotr_scratch( buffer + 1, buffer, 3, 5, 3, 5, 4, scratch, 3 * 5 * 4 ) );
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+TEST memmove_rectrot_in_buffer()
+{
+	// ... rotate images in their own buffer, dst being the rotated image without padding, via scratch of different sizes ...
+	const size_t item_sizes[] = { 1, 2, 3, 4, 8, 12, 70 };
+	const size_t sizes[][2]   = { { 3, 5 }, { 4, 6 }, { 6, 4 }, { 1, 7 }, { 7, 1 }, { 8, 12 }, { 30, 45 }, { 45, 32 } };
+	const size_t BUF_SIZE = 45 * 32 * 70;
+	static uint8_t buffer[BUF_SIZE];
+	static uint8_t expect[BUF_SIZE];
+	static uint8_t scratch[BUF_SIZE];
+
+	for( size_t is = 0; is < sizeof( item_sizes ) / sizeof( item_sizes[0] ); ++is )
+	for( size_t sz = 0; sz < sizeof( sizes ) / sizeof( sizes[0] ); ++sz )
+	for( int scratch_mode = 0; scratch_mode < 4; ++scratch_mode )
+	for( int right = 0; right < 2; ++right )
+	{
+		const size_t item_size = item_sizes[is];
+		const size_t linecnt   = sizes[sz][0];
+		const size_t linelen   = sizes[sz][1];
+		const size_t line_max  = ( linecnt > linelen ? linecnt : linelen ) * item_size;
+
+		// ... none, one line short of what the bands need, exactly what they need and a few columns per band ...
+		const size_t scratch_size[] = { 0, line_max - item_size, line_max, 3 * linecnt * item_size + line_max };
+
+		for( size_t i = 0; i < BUF_SIZE; ++i )
+			buffer[i] = (uint8_t)( i * 7 + i / 251 );
+
+		void* res;
+		if( right )
+		{
+			memcpy_rectrotr_x( expect, buffer, linecnt, linelen, linecnt, linelen, item_size );
+			res = memmove_rectrotr_scratch( buffer, buffer, linecnt, linelen, linecnt, linelen, item_size, scratch_mode ? scratch : 0, scratch_size[scratch_mode] );
+		}
+		else
+		{
+			memcpy_rectrotl_x( expect, buffer, linecnt, linelen, linecnt, linelen, item_size );
+			res = memmove_rectrotl_scratch( buffer, buffer, linecnt, linelen, linecnt, linelen, item_size, scratch_mode ? scratch : 0, scratch_size[scratch_mode] );
+		}
+		ASSERT_EQ( (void*)buffer, res );
+		ASSERT_MEM_EQ( expect, buffer, linecnt * linelen * item_size );
+	}
+
+	return GREATEST_TEST_RES_PASS;
+}
+
 ///////////////////////////////////////////////////////////////
 //                      memcpy_rectrotl                      //
 ///////////////////////////////////////////////////////////////
@@ -379,6 +897,65 @@ TEST memcpy_rectrotl_subrect()
     return GREATEST_TEST_RES_PASS;
 }
 
+// ... bigger than one tile, with a size that is not a multiple of the tile-size ...
+TEST memcpy_rectrotl_tiled()
+{
+	const size_t linecnt = 150;
+	const size_t linelen = 70;
+	const size_t srcstride = linelen + 3;
+	const size_t dststride = linecnt + 5;
+	static uint8_t src[linecnt * srcstride];
+	static uint8_t dst[linelen * dststride];
+	static uint8_t expect[linelen * dststride];
+	for(size_t i = 0; i < sizeof(src); ++i)
+		src[i] = (uint8_t)(i * 7);
+	memset(dst, 0, sizeof(dst));
+	memset(expect, 0, sizeof(expect));
+
+	for( size_t line = 0; line < linecnt; ++line )
+		for( size_t byte = 0; byte < linelen; ++byte )
+			expect[ ( linelen - byte - 1 ) * dststride + line ] = src[ line * srcstride + byte ];
+
+	memcpy_rectrotl( dst, src, linecnt, linelen, dststride, srcstride );
+	ASSERT_MEMEQ(dst, expect);
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+// ... all item-sizes, bigger than one tile and not a multiple of the transpose block-size ...
+TEST memcpy_rectrotl_x_item_sizes()
+{
+	const size_t linecnt   = 83;
+	const size_t linelen   = 71;
+	const size_t srcstride = linelen + 3;
+	const size_t dststride = linecnt + 5;
+	const size_t max_item_size = 16;
+	static uint8_t src[linecnt * srcstride * max_item_size];
+	static uint8_t dst[linelen * dststride * max_item_size];
+	static uint8_t expect[linelen * dststride * max_item_size];
+	for(size_t i = 0; i < sizeof(src); ++i)
+		src[i] = (uint8_t)(i * 7 + i / 251);
+
+	const size_t item_sizes[] = { 1, 2, 3, 4, 5, 6, 8, 12, 16 };
+	for( size_t i = 0; i < sizeof(item_sizes) / sizeof(item_sizes[0]); ++i )
+	{
+		const size_t item_size = item_sizes[i];
+		memset(dst, 0, sizeof(dst));
+		memset(expect, 0, sizeof(expect));
+
+		for( size_t line = 0; line < linecnt; ++line )
+			for( size_t item = 0; item < linelen; ++item )
+				memcpy( &expect[ ( ( linelen - item - 1 ) * dststride + line ) * item_size ],
+						&src[ ( line * srcstride + item ) * item_size ],
+						item_size );
+
+		memcpy_rectrotl_x( dst, src, linecnt, linelen, dststride, srcstride, item_size );
+		ASSERT_MEMEQ(dst, expect);
+	}
+
+    return GREATEST_TEST_RES_PASS;
+}
+
 TEST memmove_rectrotl_full()
 {
 	uint8_t buffer[] = { 'a', 'b', 'c', 'd',
@@ -420,6 +997,29 @@ TEST memmove_rectrotl_big()
     return GREATEST_TEST_RES_PASS;
 }
 
+TEST memmove_rectrotl_x_item_sizes()
+{
+	const size_t size = 9;
+	const size_t max_item_size = 64;
+	uint8_t src[size * size * max_item_size];
+	uint8_t buffer[size * size * max_item_size];
+	uint8_t expect[size * size * max_item_size];
+	for(size_t i = 0; i < sizeof(src); ++i)
+		src[i] = (uint8_t)(i * 7 + i / 251);
+
+	const size_t item_sizes[] = { 1, 2, 3, 4, 6, 8, 12, 16, 24, 32, 33, 64 };
+	for( size_t i = 0; i < sizeof(item_sizes) / sizeof(item_sizes[0]); ++i )
+	{
+		const size_t item_size = item_sizes[i];
+		memcpy(buffer, src, sizeof(buffer));
+		memcpy_rectrotl_x( expect, src, size, size, size, size, item_size );
+		memmove_rectrotl_x( buffer, buffer, size, size, size, size, item_size );
+		ASSERT_MEM_EQ(buffer, expect, size * size * item_size);
+	}
+
+    return GREATEST_TEST_RES_PASS;
+}
+
 ///////////////////////////////////////////////////////////////
 //                        memmove_rect                       //
 ///////////////////////////////////////////////////////////////
@@ -593,6 +1193,71 @@ TEST memmove_rect_overlap_diagnal_se()
     return GREATEST_TEST_RES_PASS;
 }
 
+TEST memmove_rect_overlap_classify()
+{
+	uint8_t buffer[8 * 8] = {0};
+
+	// ... same rect ...
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_INPLACE, memcpy_util_rect_overlap( &buffer[9], 4, 4, 8, &buffer[9], 4, 4, 8 ) );
+
+	// ... side by side in the same image, byte-ranges overlap but no line does ...
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_NONE,    memcpy_util_rect_overlap( &buffer[0], 8, 4, 8, &buffer[4], 8, 4, 8 ) );
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_NONE,    memcpy_util_rect_overlap( &buffer[4], 8, 4, 8, &buffer[0], 8, 4, 8 ) );
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_NONE,    memcpy_util_rect_overlap( &buffer[6], 4, 4, 8, &buffer[10], 4, 4, 8 ) );
+
+	// ... above each other ...
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_NONE,    memcpy_util_rect_overlap( &buffer[0], 4, 8, 8, &buffer[32], 4, 8, 8 ) );
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_PARTIAL, memcpy_util_rect_overlap( &buffer[0], 5, 8, 8, &buffer[32], 4, 8, 8 ) );
+
+	// ... shifted part of a line and wrapping into the next line ...
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_PARTIAL, memcpy_util_rect_overlap( &buffer[0], 4, 4, 8, &buffer[3], 4, 4, 8 ) );
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_PARTIAL, memcpy_util_rect_overlap( &buffer[6], 4, 4, 8, &buffer[11], 4, 4, 8 ) );
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_NONE,    memcpy_util_rect_overlap( &buffer[6], 1, 4, 8, &buffer[11], 4, 4, 8 ) );
+
+	// ... different strides only check the byte-ranges ...
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_PARTIAL, memcpy_util_rect_overlap( &buffer[0], 4, 4, 8, &buffer[4], 4, 4, 16 ) );
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_NONE,    memcpy_util_rect_overlap( &buffer[0], 2, 4, 8, &buffer[12], 2, 4, 16 ) );
+
+	// ... empty rects ...
+	ASSERT_EQ( MEMCPY_UTIL_OVERLAP_NONE,    memcpy_util_rect_overlap( &buffer[0], 0, 4, 8, &buffer[0], 4, 4, 8 ) );
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+TEST memmove_rect_strides()
+{
+	// ... move between all combinations of offsets and strides in one buffer and compare with going through a temporary
+	//     buffer ...
+	uint8_t buffer[128];
+	uint8_t expect[128];
+	uint8_t tmp[128];
+
+	const size_t line_cnts[] = { 1, 3, 5 };
+	const size_t line_lens[] = { 1, 3, 4 };
+	for( size_t lc = 0; lc < sizeof(line_cnts) / sizeof(line_cnts[0]); ++lc )
+	for( size_t ll = 0; ll < sizeof(line_lens) / sizeof(line_lens[0]); ++ll )
+	{
+		const size_t lines   = line_cnts[lc];
+		const size_t linelen = line_lens[ll];
+		for( size_t dststride = linelen; dststride <= 8; ++dststride )
+		for( size_t srcstride = linelen; srcstride <= 8; ++srcstride )
+		for( size_t dstoffset = 0; dstoffset <= 24; ++dstoffset )
+		for( size_t srcoffset = 0; srcoffset <= 24; ++srcoffset )
+		{
+			for( size_t i = 0; i < sizeof(buffer); ++i )
+				buffer[i] = (uint8_t)i;
+			memcpy( expect, buffer, sizeof(buffer) );
+			memcpy_rect( tmp, &expect[srcoffset], lines, linelen, linelen, srcstride );
+			memcpy_rect( &expect[dstoffset], tmp, lines, linelen, dststride, linelen );
+
+			memmove_rect( &buffer[dstoffset], &buffer[srcoffset], lines, linelen, dststride, srcstride );
+			ASSERT_MEMEQ(buffer, expect);
+		}
+	}
+
+    return GREATEST_TEST_RES_PASS;
+}
+
 ///////////////////////////////////////////////////////////////
 //                      memcpy_rectfliph                     //
 ///////////////////////////////////////////////////////////////
@@ -744,6 +1409,34 @@ TEST memmove_rectfliph_subrect()
     return GREATEST_TEST_RES_PASS;
 }
 
+TEST memmove_rectfliph_overlap()
+{
+	const size_t linecnt = 5;
+	const size_t linelen = 6;
+	const size_t stride  = 8;
+	uint8_t src[(linecnt + 2) * stride];
+	uint8_t buffer[sizeof(src)];
+	uint8_t expect[sizeof(src)];
+	for( size_t i = 0; i < sizeof(src); ++i )
+		src[i] = (uint8_t)( 'a' + i );
+
+	// ... no overlap, flip into another buffer ...
+	memset( buffer, 0, sizeof(buffer) );
+	memset( expect, 0, sizeof(expect) );
+	memmove_rectfliph( buffer, src, linecnt, linelen, stride, stride, 1 );
+	memcpy_rectfliph( expect, src, linecnt, linelen, stride, stride, 1 );
+	ASSERT_MEMEQ(buffer, expect);
+
+	// ... dst overlap src, 2 lines down and 1 item right ...
+	memcpy( buffer, src, sizeof(src) );
+	memcpy( expect, src, sizeof(src) );
+	memmove_rectfliph( &buffer[2 * stride + 1], buffer, linecnt, linelen, stride, stride, 1 );
+	memcpy_rectfliph( &expect[2 * stride + 1], src, linecnt, linelen, stride, stride, 1 );
+	ASSERT_MEMEQ(buffer, expect);
+
+    return GREATEST_TEST_RES_PASS;
+}
+
 ///////////////////////////////////////////////////////////////
 //                      memcpy_rectflipv                     //
 ///////////////////////////////////////////////////////////////
@@ -869,18 +1562,400 @@ TEST memmove_rectflipv_subrect()
     return GREATEST_TEST_RES_PASS;
 }
 
-// TODO: tests for some different sizes for memXXX_rectflipv
+TEST memcpy_rectflipv_item_sizes()
+{
+	const size_t linecnt   = 7;
+	const size_t linelen   = 45;
+	const size_t srcstride = linelen + 3;
+	const size_t dststride = linelen + 5;
+	const size_t max_item_size = 24;
+	uint8_t src[linecnt * srcstride * max_item_size];
+	uint8_t dst[linecnt * dststride * max_item_size];
+	uint8_t expect[linecnt * dststride * max_item_size];
+	for(size_t i = 0; i < sizeof(src); ++i)
+		src[i] = (uint8_t)(i * 7 + i / 251);
+
+	const size_t item_sizes[] = { 1, 2, 3, 4, 5, 6, 8, 12, 16, 24 };
+	for( size_t i = 0; i < sizeof(item_sizes) / sizeof(item_sizes[0]); ++i )
+	{
+		const size_t item_size = item_sizes[i];
+		memset(dst, 0, sizeof(dst));
+		memset(expect, 0, sizeof(expect));
+
+		for( size_t line = 0; line < linecnt; ++line )
+			for( size_t item = 0; item < linelen; ++item )
+				memcpy( &expect[ ( line * dststride + item ) * item_size ],
+						&src[ ( line * srcstride + ( linelen - item - 1 ) ) * item_size ],
+						item_size );
+
+		memcpy_rectflipv( dst, src, linecnt, linelen, dststride, srcstride, item_size );
+		ASSERT_MEMEQ(dst, expect);
+	}
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+// run the sse2-kernels of memcpy_util_reverse_line()/memcpy_util_swap_reverse_line() even if the cpu has avx2 or
+// ssse3 and compare with reversing item by item.
+template <size_t ITEM_SIZE>
+static enum greatest_test_res reverse_line_sse2( size_t linelen )
+{
+	const size_t max_linelen = 97;
+	uint8_t src[max_linelen * ITEM_SIZE];
+	uint8_t line1[max_linelen * ITEM_SIZE];
+	uint8_t line2[max_linelen * ITEM_SIZE];
+	uint8_t expect[max_linelen * ITEM_SIZE];
+	for(size_t i = 0; i < sizeof(src); ++i)
+		src[i] = (uint8_t)(i * 7 + i / 251);
+
+	memcpy_util_reverse_state state = memcpy_util_reverse_setup<ITEM_SIZE>();
+	state.avx2  = false;
+	state.ssse3 = false;
+
+	memset( expect, 0, sizeof(expect) );
+	for( size_t item = 0; item < linelen; ++item )
+		memcpy( &expect[item * ITEM_SIZE], &src[( linelen - item - 1 ) * ITEM_SIZE], ITEM_SIZE );
+
+	memset( line1, 0, sizeof(line1) );
+	memcpy_util_reverse_line<ITEM_SIZE>( line1, src, linelen, ITEM_SIZE, state );
+	ASSERT_MEM_EQ( expect, line1, linelen * ITEM_SIZE );
+
+	// ... one line reversed in place ...
+	memcpy( line1, src, sizeof(src) );
+	memcpy_util_swap_reverse_line<ITEM_SIZE>( line1, line1, linelen / 2, linelen, ITEM_SIZE, memswap, state );
+	ASSERT_MEM_EQ( expect, line1, linelen * ITEM_SIZE );
+
+	// ... two lines reversed and swapped, line2 start out as the reversed src so line1 end up as src ...
+	memcpy( line1, src, sizeof(src) );
+	memcpy( line2, expect, sizeof(expect) );
+	memcpy_util_swap_reverse_line<ITEM_SIZE>( line1, line2, linelen, linelen, ITEM_SIZE, memswap, state );
+	ASSERT_MEM_EQ( src, line1, linelen * ITEM_SIZE );
+	ASSERT_MEM_EQ( expect, line2, linelen * ITEM_SIZE );
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+TEST memcpy_util_reverse_line_sse2()
+{
+	const size_t linelens[] = { 1, 7, 45, 97 };
+	for( size_t i = 0; i < sizeof(linelens) / sizeof(linelens[0]); ++i )
+	{
+		CHECK_CALL( reverse_line_sse2<1>( linelens[i] ) );
+		CHECK_CALL( reverse_line_sse2<2>( linelens[i] ) );
+		CHECK_CALL( reverse_line_sse2<3>( linelens[i] ) );
+		CHECK_CALL( reverse_line_sse2<4>( linelens[i] ) );
+		CHECK_CALL( reverse_line_sse2<5>( linelens[i] ) );
+		CHECK_CALL( reverse_line_sse2<6>( linelens[i] ) );
+		CHECK_CALL( reverse_line_sse2<8>( linelens[i] ) );
+		CHECK_CALL( reverse_line_sse2<12>( linelens[i] ) );
+		CHECK_CALL( reverse_line_sse2<16>( linelens[i] ) );
+		CHECK_CALL( reverse_line_sse2<24>( linelens[i] ) );
+	}
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+TEST memmove_rectflipv_item_sizes()
+{
+	const size_t linecnt = 7;
+	const size_t linelen = 45;
+	const size_t stride  = linelen + 3;
+	const size_t max_item_size = 24;
+	uint8_t buffer[linecnt * stride * max_item_size];
+	uint8_t expect[linecnt * stride * max_item_size];
+
+	const size_t item_sizes[] = { 1, 2, 3, 4, 5, 6, 8, 12, 16, 24 };
+	for( size_t i = 0; i < sizeof(item_sizes) / sizeof(item_sizes[0]); ++i )
+	{
+		const size_t item_size = item_sizes[i];
+		for(size_t b = 0; b < sizeof(buffer); ++b)
+			buffer[b] = (uint8_t)(b * 7 + b / 251);
+
+		memcpy( expect, buffer, sizeof(buffer) );
+		memcpy_rectflipv( expect, buffer, linecnt, linelen, stride, stride, item_size );
+
+		memmove_rectflipv( buffer, buffer, linecnt, linelen, stride, stride, item_size );
+		ASSERT_MEMEQ(buffer, expect);
+	}
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+TEST memmove_rectflipv_overlap()
+{
+	const size_t linecnt = 5;
+	const size_t linelen = 6;
+	const size_t stride  = 8;
+	uint16_t src[(linecnt + 2) * stride];
+	uint16_t buffer[sizeof(src) / sizeof(src[0])];
+	uint16_t expect[sizeof(src) / sizeof(src[0])];
+	for( size_t i = 0; i < sizeof(src) / sizeof(src[0]); ++i )
+		src[i] = (uint16_t)( i * 257 );
+
+	// ... no overlap, flip into another buffer ...
+	memset( buffer, 0, sizeof(buffer) );
+	memset( expect, 0, sizeof(expect) );
+	memmove_rectflipv( buffer, src, linecnt, linelen, stride, stride, sizeof(uint16_t) );
+	memcpy_rectflipv( expect, src, linecnt, linelen, stride, stride, sizeof(uint16_t) );
+	ASSERT_MEMEQ(buffer, expect);
+
+	// ... dst overlap src, 1 line up and 2 items right ...
+	memcpy( buffer, src, sizeof(src) );
+	memcpy( expect, src, sizeof(src) );
+	memmove_rectflipv( &buffer[2], &buffer[stride], linecnt, linelen, stride, stride, sizeof(uint16_t) );
+	memcpy_rectflipv( &expect[2], &src[stride], linecnt, linelen, stride, stride, sizeof(uint16_t) );
+	ASSERT_MEMEQ(buffer, expect);
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+TEST rectflipv_template_item_size()
+{
+	// ... the compile time item-size versions should match the runtime ones, also for sizes not dispatched to ...
+	const size_t linecnt = 5;
+	const size_t linelen = 9;
+	const size_t stride  = linelen + 2;
+	uint8_t src[linecnt * stride * 20];
+	uint8_t dst[sizeof(src)];
+	uint8_t expect[sizeof(src)];
+	for(size_t i = 0; i < sizeof(src); ++i)
+		src[i] = (uint8_t)(i * 13);
+
+	memset(dst, 0, sizeof(dst));
+	memset(expect, 0, sizeof(expect));
+	memcpy_rectflipv<4>( dst, src, linecnt, linelen, stride, stride );
+	memcpy_rectflipv( expect, src, linecnt, linelen, stride, stride, 4 );
+	ASSERT_MEMEQ(dst, expect);
+
+	memset(dst, 0, sizeof(dst));
+	memset(expect, 0, sizeof(expect));
+	memcpy_rectflipv<20>( dst, src, linecnt, linelen, stride, stride );
+	memcpy_rectflipv( expect, src, linecnt, linelen, stride, stride, 20 );
+	ASSERT_MEMEQ(dst, expect);
+
+	memcpy( dst, src, sizeof(src) );
+	memcpy( expect, src, sizeof(src) );
+	memmove_rectflipv<20>( dst, dst, linecnt, linelen, stride, stride );
+	memmove_rectflipv( expect, expect, linecnt, linelen, stride, stride, 20 );
+	ASSERT_MEMEQ(dst, expect);
+
+	memset(dst, 0, sizeof(dst));
+	memset(expect, 0, sizeof(expect));
+	memcpy_rectrotr_x<20>( dst, src, linecnt, linelen, linecnt, stride );
+	memcpy_rectrotr_x( expect, src, linecnt, linelen, linecnt, stride, 20 );
+	ASSERT_MEMEQ(dst, expect);
+
+	memset(dst, 0, sizeof(dst));
+	memset(expect, 0, sizeof(expect));
+	memcpy_rectrotl_x<20>( dst, src, linecnt, linelen, linecnt, stride );
+	memcpy_rectrotl_x( expect, src, linecnt, linelen, linecnt, stride, 20 );
+	ASSERT_MEMEQ(dst, expect);
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+///////////////////////////////////////////////////////////////
+//                     memcpy_rectrot180                     //
+///////////////////////////////////////////////////////////////
+
+TEST memcpy_rectrot180_subrect()
+{
+	uint8_t buffer[] = { 'a', 'b', 'c', 'd',
+						 'e', 'f', 'g', 'h',
+						 'i', 'j', 'k', 'l',
+						 'A', 'B', 'C', 'D',
+						 'E', 'F', 'G', 'H' };
+
+	uint8_t expect[] = { 'k', 'j', 'i', 0,
+						 'g', 'f', 'e', 0,
+						 'c', 'b', 'a', 0,
+						  0,   0,   0,  0,
+						  0,   0,   0,  0 };
+
+	uint8_t dst[sizeof(buffer)] = {0};
+	memcpy_rectrot180( dst, buffer, 3, 3, 4, 4, sizeof(uint8_t) );
+	ASSERT_MEMEQ(dst, expect);
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+TEST memcpy_rectrot180_item_sizes()
+{
+	const size_t linecnt   = 7;
+	const size_t linelen   = 45;
+	const size_t srcstride = linelen + 3;
+	const size_t dststride = linelen + 5;
+	const size_t max_item_size = 24;
+	uint8_t src[linecnt * srcstride * max_item_size];
+	uint8_t dst[linecnt * dststride * max_item_size];
+	uint8_t expect[linecnt * dststride * max_item_size];
+	for(size_t i = 0; i < sizeof(src); ++i)
+		src[i] = (uint8_t)(i * 7 + i / 251);
+
+	const size_t item_sizes[] = { 1, 2, 3, 4, 5, 6, 8, 12, 16, 24 };
+	for( size_t i = 0; i < sizeof(item_sizes) / sizeof(item_sizes[0]); ++i )
+	{
+		const size_t item_size = item_sizes[i];
+		memset(dst, 0, sizeof(dst));
+		memset(expect, 0, sizeof(expect));
+
+		for( size_t line = 0; line < linecnt; ++line )
+			for( size_t item = 0; item < linelen; ++item )
+				memcpy( &expect[ ( line * dststride + item ) * item_size ],
+						&src[ ( ( linecnt - line - 1 ) * srcstride + ( linelen - item - 1 ) ) * item_size ],
+						item_size );
+
+		memcpy_rectrot180( dst, src, linecnt, linelen, dststride, srcstride, item_size );
+		ASSERT_MEMEQ(dst, expect);
+	}
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+///////////////////////////////////////////////////////////////
+//                     memmove_rectrot180                    //
+///////////////////////////////////////////////////////////////
+
+TEST memmove_rectrot180_item_sizes()
+{
+	// ... both an even and an odd line count, in the odd case the middle line is only reversed ...
+	const size_t linelen = 45;
+	const size_t stride  = linelen + 3;
+	const size_t max_item_size = 24;
+	uint8_t buffer[8 * stride * max_item_size];
+	uint8_t expect[8 * stride * max_item_size];
+
+	const size_t item_sizes[] = { 1, 2, 3, 4, 5, 6, 8, 12, 16, 24 };
+	for( size_t linecnt = 7; linecnt <= 8; ++linecnt )
+	for( size_t i = 0; i < sizeof(item_sizes) / sizeof(item_sizes[0]); ++i )
+	{
+		const size_t item_size = item_sizes[i];
+		for(size_t b = 0; b < sizeof(buffer); ++b)
+			buffer[b] = (uint8_t)(b * 7 + b / 251);
+
+		memcpy( expect, buffer, sizeof(buffer) );
+		memcpy_rectrot180( expect, buffer, linecnt, linelen, stride, stride, item_size );
+
+		memmove_rectrot180( buffer, buffer, linecnt, linelen, stride, stride, item_size );
+		ASSERT_MEMEQ(buffer, expect);
+	}
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+TEST memmove_rectrot180_overlap()
+{
+	const size_t linecnt = 5;
+	const size_t linelen = 6;
+	const size_t stride  = 8;
+	uint32_t src[(linecnt + 2) * stride];
+	uint32_t buffer[sizeof(src) / sizeof(src[0])];
+	uint32_t expect[sizeof(src) / sizeof(src[0])];
+	for( size_t i = 0; i < sizeof(src) / sizeof(src[0]); ++i )
+		src[i] = (uint32_t)( i * 0x01010101 );
+
+	// ... no overlap, rotate into another buffer ...
+	memset( buffer, 0, sizeof(buffer) );
+	memset( expect, 0, sizeof(expect) );
+	memmove_rectrot180( buffer, src, linecnt, linelen, stride, stride, sizeof(uint32_t) );
+	memcpy_rectrot180( expect, src, linecnt, linelen, stride, stride, sizeof(uint32_t) );
+	ASSERT_MEMEQ(buffer, expect);
+
+	// ... dst overlap src, 2 lines down and 1 item right ...
+	memcpy( buffer, src, sizeof(src) );
+	memcpy( expect, src, sizeof(src) );
+	memmove_rectrot180( &buffer[2 * stride + 1], buffer, linecnt, linelen, stride, stride, sizeof(uint32_t) );
+	memcpy_rectrot180( &expect[2 * stride + 1], src, linecnt, linelen, stride, stride, sizeof(uint32_t) );
+	ASSERT_MEMEQ(buffer, expect);
+
+	// ... template version ...
+	memcpy( buffer, src, sizeof(src) );
+	memcpy( expect, src, sizeof(src) );
+	memmove_rectrot180<sizeof(uint32_t)>( buffer, buffer, linecnt, linelen, stride, stride );
+	memcpy_rectrot180<sizeof(uint32_t)>( expect, src, linecnt, linelen, stride, stride );
+	ASSERT_MEMEQ(buffer, expect);
+
+    return GREATEST_TEST_RES_PASS;
+}
+
+///////////////////////////////////////////////////////////////
+//                     memcpy_rectorient                     //
+///////////////////////////////////////////////////////////////
+
+TEST memcpy_rectorient_all()
+{
+	// ... crop a sub-rect from a bigger image and compare all orientations to the same op done in multiple passes ...
+	const size_t img_lines  = 60;
+	const size_t img_len    = 70;
+	const size_t linecnt    = 37;
+	const size_t linelen    = 53;
+	const size_t max_item_size = 16;
+	const size_t dststride  = 60;
+	static uint8_t img[img_lines * img_len * max_item_size];
+	static uint8_t dst[dststride * dststride * max_item_size];
+	static uint8_t tmp[dststride * dststride * max_item_size];
+	static uint8_t expect[dststride * dststride * max_item_size];
+	for(size_t i = 0; i < sizeof(img); ++i)
+		img[i] = (uint8_t)(i * 7 + i / 251);
+
+	const size_t item_sizes[] = { 1, 3, 4, 8, 16 };
+	for( size_t i = 0; i < sizeof(item_sizes) / sizeof(item_sizes[0]); ++i )
+	for( int o = 0; o < MEMCPY_RECT_ORIENT_COUNT; ++o )
+	{
+		const size_t item_size = item_sizes[i];
+		uint8_t* src = &img[ ( 5 * img_len + 7 ) * item_size ];
+		memset(dst, 0, sizeof(dst));
+		memset(expect, 0, sizeof(expect));
+
+		switch( (memcpy_rect_orientation)o )
+		{
+			case MEMCPY_RECT_ORIENT_IDENTITY: memcpy_rect( expect, src, linecnt, linelen * item_size, dststride * item_size, img_len * item_size ); break;
+			case MEMCPY_RECT_ORIENT_ROTR:     memcpy_rectrotr_x( expect, src, linecnt, linelen, dststride, img_len, item_size ); break;
+			case MEMCPY_RECT_ORIENT_ROT180:   memcpy_rectrot180( expect, src, linecnt, linelen, dststride, img_len, item_size ); break;
+			case MEMCPY_RECT_ORIENT_ROTL:     memcpy_rectrotl_x( expect, src, linecnt, linelen, dststride, img_len, item_size ); break;
+			case MEMCPY_RECT_ORIENT_FLIPH:    memcpy_rectfliph( expect, src, linecnt, linelen, dststride, img_len, item_size ); break;
+			case MEMCPY_RECT_ORIENT_FLIPV:    memcpy_rectflipv( expect, src, linecnt, linelen, dststride, img_len, item_size ); break;
+			case MEMCPY_RECT_ORIENT_TRANSPOSE:
+				memcpy_rectrotr_x( tmp, src, linecnt, linelen, dststride, img_len, item_size );
+				memcpy_rectflipv( expect, tmp, linelen, linecnt, dststride, dststride, item_size );
+				break;
+			case MEMCPY_RECT_ORIENT_TRANSVERSE:
+				memcpy_rectrotr_x( tmp, src, linecnt, linelen, dststride, img_len, item_size );
+				memcpy_rectfliph( expect, tmp, linelen, linecnt, dststride, dststride, item_size );
+				break;
+			case MEMCPY_RECT_ORIENT_COUNT:
+				break;
+		}
+
+		memcpy_rectorient( dst, src, linecnt, linelen, dststride, img_len, item_size, (memcpy_rect_orientation)o );
+		ASSERT_MEMEQ(dst, expect);
+	}
+
+	// ... and the template version ...
+	memset(dst, 0, sizeof(dst));
+	memset(expect, 0, sizeof(expect));
+	memcpy_rectorient<4>( dst, img, linecnt, linelen, dststride, img_len, MEMCPY_RECT_ORIENT_TRANSVERSE );
+	memcpy_rectorient( expect, img, linecnt, linelen, dststride, img_len, 4, MEMCPY_RECT_ORIENT_TRANSVERSE );
+	ASSERT_MEMEQ(dst, expect);
+
+    return GREATEST_TEST_RES_PASS;
+}
 
 GREATEST_SUITE( swap )
 {
 	RUN_TEST( memswap_simple     );
 	RUN_TEST( memswap_many_sizes );
 	RUN_TEST( memswap_unaligned  );
+	RUN_TEST( memswap_unaligned_mixed );
+	RUN_TEST( memswap_set_kernel );
+	RUN_TEST( memswap_stream_threshold );
+	RUN_TEST( memswap_parallel_many_sizes );
 }
 
 GREATEST_SUITE( rect )
 {
 	RUN_TEST( memcpy_rect_simple );
+	RUN_TEST( memcpy_rect_parallel_lines );
 
     RUN_TEST( memmove_rect_simple             );
     RUN_TEST( memmove_rect_no_overlap_n       );
@@ -892,6 +1967,8 @@ GREATEST_SUITE( rect )
     RUN_TEST( memmove_rect_overlap_diagnal_ne );
     RUN_TEST( memmove_rect_overlap_diagnal_sw );
     RUN_TEST( memmove_rect_overlap_diagnal_se );
+    RUN_TEST( memmove_rect_overlap_classify   );
+    RUN_TEST( memmove_rect_strides            );
 };
 
 GREATEST_SUITE( rectrotr )
@@ -900,9 +1977,16 @@ GREATEST_SUITE( rectrotr )
     RUN_TEST( memcpy_rectrotr_big     );
     RUN_TEST( memcpy_rectrotr_simple  );
     RUN_TEST( memcpy_rectrotr_subrect );
+    RUN_TEST( memcpy_rectrotr_tiled   );
+    RUN_TEST( memcpy_rectrotr_x_item_sizes );
 
     RUN_TEST( memmove_rectrotr_full   );
     RUN_TEST( memmove_rectrotr_big    );
+    RUN_TEST( memmove_rectrotr_x_item_sizes );
+    RUN_TEST( memmove_rectrotr_no_overlap );
+    RUN_TEST( memmove_rectrot_non_square );
+    RUN_TEST( memmove_rectrot_in_buffer );
+    RUN_TEST( memmove_rectrot_square_tiled );
 };
 
 GREATEST_SUITE( rectrotl )
@@ -910,9 +1994,12 @@ GREATEST_SUITE( rectrotl )
     RUN_TEST( memcpy_rectrotl_full    );
     RUN_TEST( memcpy_rectrotl_simple  );
     RUN_TEST( memcpy_rectrotl_subrect );
+    RUN_TEST( memcpy_rectrotl_tiled   );
+    RUN_TEST( memcpy_rectrotl_x_item_sizes );
 
     RUN_TEST( memmove_rectrotl_full   );
     RUN_TEST( memmove_rectrotl_big    );
+    RUN_TEST( memmove_rectrotl_x_item_sizes );
 };
 
 GREATEST_SUITE( rectfliph )
@@ -924,6 +2011,7 @@ GREATEST_SUITE( rectfliph )
     RUN_TEST( memmove_rectfliph_even    );
     RUN_TEST( memmove_rectfliph_uneven  );
     RUN_TEST( memmove_rectfliph_subrect );
+    RUN_TEST( memmove_rectfliph_overlap );
 };
 
 GREATEST_SUITE( rectflipv )
@@ -931,10 +2019,30 @@ GREATEST_SUITE( rectflipv )
     RUN_TEST( memcpy_rectflipv_even    );
     RUN_TEST( memcpy_rectflipv_uneven  );
     RUN_TEST( memcpy_rectflipv_subrect );
+    RUN_TEST( memcpy_rectflipv_item_sizes );
+    RUN_TEST( memcpy_util_reverse_line_sse2 );
 
     RUN_TEST( memmove_rectflipv_even    );
     RUN_TEST( memmove_rectflipv_uneven  );
     RUN_TEST( memmove_rectflipv_subrect );
+    RUN_TEST( memmove_rectflipv_item_sizes );
+    RUN_TEST( memmove_rectflipv_overlap );
+
+    RUN_TEST( rectflipv_template_item_size );
+};
+
+GREATEST_SUITE( rectrot180 )
+{
+    RUN_TEST( memcpy_rectrot180_subrect    );
+    RUN_TEST( memcpy_rectrot180_item_sizes );
+
+    RUN_TEST( memmove_rectrot180_item_sizes );
+    RUN_TEST( memmove_rectrot180_overlap    );
+};
+
+GREATEST_SUITE( rectorient )
+{
+    RUN_TEST( memcpy_rectorient_all );
 };
 
 GREATEST_MAIN_DEFS();
@@ -948,5 +2056,7 @@ int main( int argc, char **argv )
     RUN_SUITE( rectrotl );
     RUN_SUITE( rectfliph );
     RUN_SUITE( rectflipv );
+    RUN_SUITE( rectrot180 );
+    RUN_SUITE( rectorient );
     GREATEST_MAIN_END();
 }
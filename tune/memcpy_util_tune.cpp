@@ -0,0 +1,286 @@
+/*
+ Header containing utility functions for copying memory in different ways.
+
+ Most functions exist in a memcpy_- and a memmove_-version where the move
+ versions trade performance for being able to work within overlapping
+ memory regions.
+
+ version 1.0, March, 2023
+
+ Copyright (C) 2023- Fredrik Kihlander
+
+ This software is provided 'as-is', without any express or implied
+ warranty.  In no event will the authors be held liable for any damages
+ arising from the use of this software.
+
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it
+ freely, subject to the following restrictions:
+
+ 1. The origin of this software must not be misrepresented; you must not
+ claim that you wrote the original software. If you use this software
+ in a product, an acknowledgment in the product documentation would be
+ appreciated but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be
+ misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+
+ Fredrik Kihlander
+ */
+
+// memcpy_util_tune, benchmarks candidate values for the tunables of memcpy_util.h on this machine and writes them to
+// memcpy_util_tuning.h, or the path passed as first argument, that memcpy_util.h picks up if found.
+//
+// * compile-time tunables are picked among the variants linked in from memcpy_util_tune_variant.cpp, one per
+//   candidate value, see bam.lua. A candidate has to beat the default by TUNE_MIN_GAIN to be picked.
+// * the cut-over sizes for streaming stores and threading are measured with this default build of memcpy_util.h by
+//   finding the smallest size where the streaming/threaded version wins for that size and most sizes above, see
+//   tune_cut_over().
+
+#include "memcpy_util_tune.h"
+
+#define MEMCPY_UTIL_NO_TUNING_HEADER
+#include "../memcpy_util.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+
+static const double TUNE_MIN_GAIN = 0.03;
+static const int    TUNE_ROUNDS   = 3;
+
+static const memcpy_util_tune_variant* tune_variants[64];
+static size_t tune_variant_count;
+
+void memcpy_util_tune_register( const memcpy_util_tune_variant* variant )
+{
+	if(tune_variant_count < sizeof(tune_variants) / sizeof(tune_variants[0]))
+		tune_variants[tune_variant_count++] = variant;
+}
+
+double memcpy_util_tune_min_ns( void (*op)( void* data ), void* data, int reps )
+{
+	op(data);
+
+	double best = 1e300;
+	for(int i = 0; i < reps; ++i)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		op(data);
+		double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+		best = ns < best ? ns : best;
+	}
+	return best;
+}
+
+static const char* TUNABLE_NAMES[MEMCPY_UTIL_TUNABLE_COUNT] = {
+	"MEMCPY_UTIL_MEMSWAP_CHUNK_SIZE",
+	"MEMCPY_UTIL_MEMSWAP_UNROLL",
+	"MEMCPY_UTIL_ROTATE_TILE_SIZE",
+	"MEMCPY_UTIL_STREAM_PREFETCH_DISTANCE",
+};
+
+static const size_t TUNABLE_DEFAULTS[MEMCPY_UTIL_TUNABLE_COUNT] = {
+	MEMCPY_UTIL_MEMSWAP_CHUNK_SIZE,
+	MEMCPY_UTIL_MEMSWAP_UNROLL,
+	MEMCPY_UTIL_ROTATE_TILE_SIZE,
+	MEMCPY_UTIL_STREAM_PREFETCH_DISTANCE,
+};
+
+// time all variants that only differ from the defaults in tunable and return the fastest value. Candidates are timed
+// interleaved over TUNE_ROUNDS rounds, keeping the best time of each, so that a hiccup only hurts one of them once.
+static size_t tune_compile_time( int tunable )
+{
+	const memcpy_util_tune_variant* candidates[64];
+	double candidate_ns[64];
+	size_t candidate_count = 0;
+
+	for(size_t v = 0; v < tune_variant_count; ++v)
+	{
+		const memcpy_util_tune_variant* variant = tune_variants[v];
+
+		bool only_tunable = true;
+		for(int t = 0; t < MEMCPY_UTIL_TUNABLE_COUNT; ++t)
+			only_tunable &= t == tunable || variant->values[t] == TUNABLE_DEFAULTS[t];
+
+		// ... the default is in the candidates of all tunables, no need to time it more than once ...
+		for(size_t c = 0; c < candidate_count; ++c)
+			only_tunable &= candidates[c]->values[tunable] != variant->values[tunable];
+
+		if(only_tunable)
+		{
+			candidate_ns[candidate_count] = 0.0;
+			candidates[candidate_count++] = variant;
+		}
+	}
+
+	for(int round = 0; round < TUNE_ROUNDS; ++round)
+		for(size_t c = 0; c < candidate_count; ++c)
+		{
+			const double ns = candidates[c]->time_ns[tunable]();
+			candidate_ns[c] = round == 0 || ns < candidate_ns[c] ? ns : candidate_ns[c];
+		}
+
+	double default_ns = 0.0;
+	double best_ns    = 0.0;
+	size_t best       = TUNABLE_DEFAULTS[tunable];
+	for(size_t c = 0; c < candidate_count; ++c)
+	{
+		const size_t value = candidates[c]->values[tunable];
+		printf("  %s %zu: %.0fns\n", TUNABLE_NAMES[tunable], value, candidate_ns[c]);
+
+		if(value == TUNABLE_DEFAULTS[tunable])
+			default_ns = candidate_ns[c];
+		if(best_ns == 0.0 || candidate_ns[c] < best_ns)
+		{
+			best_ns = candidate_ns[c];
+			best    = value;
+		}
+	}
+
+	if(default_ns == 0.0 || best_ns > default_ns * (1.0 - TUNE_MIN_GAIN))
+		return TUNABLE_DEFAULTS[tunable];
+	return best;
+}
+
+struct tune_swap_data
+{
+	uint8_t* b1;
+	uint8_t* b2;
+	size_t   size;
+	memcpy_util_parallel par;
+};
+
+static void tune_parallel_for( void (*job)( void* job_data, size_t job_index ), void* job_data, size_t job_count, void* userdata )
+{
+	(void)userdata;
+	std::thread threads[16];
+	for(size_t i = 1; i < job_count; ++i)
+		threads[i] = std::thread(job, job_data, i);
+	job(job_data, 0);
+	for(size_t i = 1; i < job_count; ++i)
+		threads[i].join();
+}
+
+// ... memswap() with or without streaming stores ...
+static void tune_stream_setup( tune_swap_data* d, bool candidate ) { (void)d; memswap_set_stream_threshold(candidate ? 0 : SIZE_MAX); }
+static void tune_stream_op( void* data )
+{
+	tune_swap_data* d = (tune_swap_data*)data;
+	memswap(d->b1, d->b2, d->size);
+}
+
+// ... memswap_parallel() on one or all threads ...
+static void tune_parallel_setup( tune_swap_data* d, bool candidate ) { d->par.min_bytes = candidate ? 0 : SIZE_MAX; }
+static void tune_parallel_op( void* data )
+{
+	tune_swap_data* d = (tune_swap_data*)data;
+	memswap_parallel(d->b1, d->b2, d->size, &d->par);
+}
+
+// cut-over size for a candidate in [256kb, 128mb], SIZE_MAX if there is none. All sizes are measured, baseline and
+// candidate interleaved over TUNE_ROUNDS rounds as in tune_compile_time(), and the candidate wins a size if it is
+// faster by TUNE_MIN_GAIN. The cut-over is the smallest size that the candidate wins where it also wins more sizes
+// than it loses from there and up, so that one noisy size neither disable the candidate nor move the cut-over far.
+static size_t tune_cut_over( const char* name, void (*setup)( tune_swap_data* d, bool candidate ), void (*op)( void* data ), size_t job_count )
+{
+	static const size_t MIN_SIZE = 256 * 1024;
+	static const size_t MAX_SIZE = 128 * 1024 * 1024;
+
+	bool   wins[16];
+	size_t size_count = 0;
+	for(size_t size = MIN_SIZE; size <= MAX_SIZE; size *= 2)
+	{
+		tune_swap_data d = { (uint8_t*)malloc(size), (uint8_t*)malloc(size), size, { tune_parallel_for, 0, job_count, 0 } };
+		memset(d.b1, 0x12, size);
+		memset(d.b2, 0x34, size);
+
+		const int reps = size >= 16 * 1024 * 1024 ? 5 : 20;
+		double baseline_ns  = 0.0;
+		double candidate_ns = 0.0;
+		for(int round = 0; round < TUNE_ROUNDS; ++round)
+		{
+			setup(&d, false);
+			const double b_ns = memcpy_util_tune_min_ns(op, &d, reps);
+			setup(&d, true);
+			const double c_ns = memcpy_util_tune_min_ns(op, &d, reps);
+			baseline_ns  = round == 0 || b_ns < baseline_ns  ? b_ns : baseline_ns;
+			candidate_ns = round == 0 || c_ns < candidate_ns ? c_ns : candidate_ns;
+		}
+		setup(&d, false);
+
+		free(d.b1);
+		free(d.b2);
+
+		wins[size_count++] = candidate_ns < baseline_ns * (1.0 - TUNE_MIN_GAIN);
+		printf("  %s %zu: %.0fns -> %.0fns%s\n", name, size, baseline_ns, candidate_ns, wins[size_count - 1] ? " (win)" : "");
+	}
+
+	size_t cut_over = SIZE_MAX;
+	int    balance  = 0;
+	for(size_t i = size_count; i > 0; --i)
+	{
+		balance += wins[i - 1] ? 1 : -1;
+		if(wins[i - 1] && balance > 0)
+			cut_over = MIN_SIZE << (i - 1);
+	}
+	return cut_over;
+}
+
+static void tune_write_size( FILE* f, const char* name, size_t value )
+{
+	fprintf(f, "#if !defined(%s)\n", name);
+	if(value == SIZE_MAX)
+		fprintf(f, "#\tdefine %s SIZE_MAX\n", name);
+	else
+		fprintf(f, "#\tdefine %s %zu\n", name, value);
+	fprintf(f, "#endif\n\n");
+}
+
+int main( int argc, const char** argv )
+{
+	const char* output = argc > 1 ? argv[1] : "memcpy_util_tuning.h";
+
+	size_t values[MEMCPY_UTIL_TUNABLE_COUNT];
+	for(int t = 0; t < MEMCPY_UTIL_TUNABLE_COUNT; ++t)
+	{
+		printf("%s\n", TUNABLE_NAMES[t]);
+		values[t] = tune_compile_time(t);
+	}
+
+	printf("MEMCPY_UTIL_MEMSWAP_STREAM_THRESHOLD\n");
+	const size_t stream_threshold = tune_cut_over("stream", tune_stream_setup, tune_stream_op, 1);
+
+	// ... threading can't win on a single core, keep the default there ...
+	size_t threads = std::thread::hardware_concurrency();
+	threads = threads > 16 ? 16 : threads;
+	size_t parallel_min_bytes = MEMCPY_UTIL_PARALLEL_MIN_BYTES;
+	if(threads > 1)
+	{
+		printf("MEMCPY_UTIL_PARALLEL_MIN_BYTES\n");
+		parallel_min_bytes = tune_cut_over("parallel", tune_parallel_setup, tune_parallel_op, threads);
+	}
+
+	FILE* f = fopen(output, "w");
+	if(f == 0)
+	{
+		printf("failed to open %s for writing\n", output);
+		return 1;
+	}
+
+	fprintf(f, "// generated by memcpy_util_tune, re-run the memcpy_util_tune target to update.\n");
+	fprintf(f, "// values defined before including memcpy_util.h still win over these.\n");
+	fprintf(f, "#pragma once\n\n");
+	for(int t = 0; t < MEMCPY_UTIL_TUNABLE_COUNT; ++t)
+		tune_write_size(f, TUNABLE_NAMES[t], values[t]);
+	tune_write_size(f, "MEMCPY_UTIL_MEMSWAP_STREAM_THRESHOLD", stream_threshold);
+	if(threads > 1)
+		tune_write_size(f, "MEMCPY_UTIL_PARALLEL_MIN_BYTES", parallel_min_bytes);
+	else
+		fprintf(f, "// MEMCPY_UTIL_PARALLEL_MIN_BYTES not tuned, single core machine.\n");
+	fclose(f);
+
+	printf("wrote %s\n", output);
+	return 0;
+}
@@ -0,0 +1,59 @@
+/*
+ Header containing utility functions for copying memory in different ways.
+
+ Most functions exist in a memcpy_- and a memmove_-version where the move
+ versions trade performance for being able to work within overlapping
+ memory regions.
+
+ version 1.0, March, 2023
+
+ Copyright (C) 2023- Fredrik Kihlander
+
+ This software is provided 'as-is', without any express or implied
+ warranty.  In no event will the authors be held liable for any damages
+ arising from the use of this software.
+
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it
+ freely, subject to the following restrictions:
+
+ 1. The origin of this software must not be misrepresented; you must not
+ claim that you wrote the original software. If you use this software
+ in a product, an acknowledgment in the product documentation would be
+ appreciated but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be
+ misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+
+ Fredrik Kihlander
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+// the compile-time tunables of memcpy_util.h that memcpy_util_tune picks values for by building one variant of
+// memcpy_util.h per candidate value, see memcpy_util_tune_variant.cpp.
+enum memcpy_util_tunable
+{
+	MEMCPY_UTIL_TUNABLE_MEMSWAP_CHUNK_SIZE,
+	MEMCPY_UTIL_TUNABLE_MEMSWAP_UNROLL,
+	MEMCPY_UTIL_TUNABLE_ROTATE_TILE_SIZE,
+	MEMCPY_UTIL_TUNABLE_STREAM_PREFETCH_DISTANCE,
+
+	MEMCPY_UTIL_TUNABLE_COUNT
+};
+
+// one build of memcpy_util.h, the values of all tunables it was built with and functions timing the op each tunable
+// affects, in ns.
+struct memcpy_util_tune_variant
+{
+	size_t values[MEMCPY_UTIL_TUNABLE_COUNT];
+	double (*time_ns[MEMCPY_UTIL_TUNABLE_COUNT])();
+};
+
+// called by each variant during static initialization, variant must stay alive for the duration of the program.
+void memcpy_util_tune_register( const memcpy_util_tune_variant* variant );
+
+// fastest of reps calls to op after one warm-up call, in ns.
+double memcpy_util_tune_min_ns( void (*op)( void* data ), void* data, int reps );
@@ -0,0 +1,161 @@
+/*
+ Header containing utility functions for copying memory in different ways.
+
+ Most functions exist in a memcpy_- and a memmove_-version where the move
+ versions trade performance for being able to work within overlapping
+ memory regions.
+
+ version 1.0, March, 2023
+
+ Copyright (C) 2023- Fredrik Kihlander
+
+ This software is provided 'as-is', without any express or implied
+ warranty.  In no event will the authors be held liable for any damages
+ arising from the use of this software.
+
+ Permission is granted to anyone to use this software for any purpose,
+ including commercial applications, and to alter it and redistribute it
+ freely, subject to the following restrictions:
+
+ 1. The origin of this software must not be misrepresented; you must not
+ claim that you wrote the original software. If you use this software
+ in a product, an acknowledgment in the product documentation would be
+ appreciated but is not required.
+ 2. Altered source versions must be plainly marked as such, and must not be
+ misrepresented as being the original software.
+ 3. This notice may not be removed or altered from any source distribution.
+
+ Fredrik Kihlander
+ */
+
+// one build of memcpy_util.h with a tunable set by bam.lua, i.e. -DMEMCPY_UTIL_ROTATE_TILE_SIZE=32. This file is
+// compiled once per candidate value with MEMCPY_UTIL_TUNE_VARIANT set to a unique name that memcpy_util.h is wrapped
+// in so that all variants can be linked into memcpy_util_tune.
+
+#if !defined(MEMCPY_UTIL_TUNE_VARIANT)
+#	error "MEMCPY_UTIL_TUNE_VARIANT need to be defined to a unique namespace for each variant"
+#endif
+
+#include "memcpy_util_tune.h"
+
+// ... everything memcpy_util.h includes is included outside of the namespace first so that only memcpy_util itself
+//     ends up in it ...
+#include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <immintrin.h>
+
+// ... a tuning-header from an earlier run would otherwise leak into the candidates ...
+#define MEMCPY_UTIL_NO_TUNING_HEADER
+
+namespace MEMCPY_UTIL_TUNE_VARIANT
+{
+#include "../memcpy_util.h"
+}
+
+namespace
+{
+
+using namespace MEMCPY_UTIL_TUNE_VARIANT;
+
+struct tune_buffers
+{
+	uint8_t* b1;
+	uint8_t* b2;
+	size_t   size;
+};
+
+static tune_buffers tune_alloc( size_t size )
+{
+	tune_buffers b = { (uint8_t*)malloc(size), (uint8_t*)malloc(size), size };
+	memset(b.b1, 0x12, size);
+	memset(b.b2, 0x34, size);
+	return b;
+}
+
+static void tune_free( tune_buffers& b )
+{
+	free(b.b1);
+	free(b.b2);
+}
+
+static double tune_time( void (*op)( void* data ), size_t size, int reps )
+{
+	tune_buffers b = tune_alloc(size);
+	double ns = memcpy_util_tune_min_ns(op, &b, reps);
+	tune_free(b);
+	return ns;
+}
+
+// ... memswap_memcpy is only used when picked as kernel, swap within L2 where the memcpy-calls per chunk show ...
+static void memswap_memcpy_op( void* data )
+{
+	tune_buffers* b = (tune_buffers*)data;
+	memswap_memcpy(b->b1, b->b2, b->size);
+}
+
+static double time_memswap_memcpy() { return tune_time(memswap_memcpy_op, 64 * 1024, 200); }
+
+// ... the kernel memswap() picks on this cpu, in L1 and L2 ...
+static void memswap_best_op( void* data )
+{
+	tune_buffers* b = (tune_buffers*)data;
+	memswap_kernel_func(memswap_best_kernel())(b->b1, b->b2, b->size);
+}
+
+static double time_memswap_unroll()
+{
+	return tune_time(memswap_best_op, 16 * 1024, 400) + tune_time(memswap_best_op, 512 * 1024, 50);
+}
+
+// ... rotation out of place and in place, both way bigger than L2 ...
+static void rectrot_op( void* data )
+{
+	tune_buffers* b = (tune_buffers*)data;
+	memcpy_rectrotr_x(b->b2, b->b1, 1024, 1024, 1024, 1024, sizeof(uint32_t));
+}
+
+static void rectrot_inplace_op( void* data )
+{
+	tune_buffers* b = (tune_buffers*)data;
+	memmove_rectrotr(b->b1, b->b1, 2048, 2048, 2048, 2048);
+}
+
+static double time_rotate()
+{
+	return tune_time(rectrot_op, 1024 * 1024 * sizeof(uint32_t), 10) + tune_time(rectrot_inplace_op, 2048 * 2048, 10);
+}
+
+// ... the streaming kernel memswap() picks for big buffers ...
+static void memswap_stream_op( void* data )
+{
+	tune_buffers* b = (tune_buffers*)data;
+	memswap_kernel_func(memswap_best_stream_kernel())(b->b1, b->b2, b->size);
+}
+
+static double time_memswap_stream() { return tune_time(memswap_stream_op, 32 * 1024 * 1024, 10); }
+
+static const memcpy_util_tune_variant variant = {
+	{
+		MEMCPY_UTIL_MEMSWAP_CHUNK_SIZE,
+		MEMCPY_UTIL_MEMSWAP_UNROLL,
+		MEMCPY_UTIL_ROTATE_TILE_SIZE,
+		MEMCPY_UTIL_STREAM_PREFETCH_DISTANCE,
+	},
+	{
+		time_memswap_memcpy,
+		time_memswap_unroll,
+		time_rotate,
+		time_memswap_stream,
+	}
+};
+
+struct tune_register_variant
+{
+	tune_register_variant() { memcpy_util_tune_register(&variant); }
+};
+
+static tune_register_variant register_variant;
+
+}